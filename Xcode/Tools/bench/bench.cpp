@@ -0,0 +1,486 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ Benchmark harness for the grob, hpfont and hpnote tools.
+ 
+ Generates inputs for each tool: BMP images of 1, 4, 8, 16 and 32 bits per pixel
+ and PBM images from small to large, Adafruit GFX font headers with many glyphs,
+ and NoteText and Markdown notes with large \pict groups. Each is run through its
+ tool, which times its load, convert and emit phases itself when given
+ --profile-json, and the peak resident set size of each run is taken from the
+ operating system.
+ 
+ The output of every run is digested and compared against the digests recorded
+ in a golden file, failing if any output has changed, has no digest recorded, or
+ if the golden file itself is missing.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <filesystem>
+#include <algorithm>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+namespace fs = std::filesystem;
+
+typedef struct TWorkload {
+    std::string name;
+    std::string tool;
+    fs::path input;
+    std::string extension;      // of the output file
+} TWorkload;
+
+typedef struct TResult {
+    std::string name;
+    long long load = 0;         // nanoseconds
+    long long convert = 0;
+    long long emit = 0;
+    long long rss = 0;          // peak resident set size in kilobytes
+    std::string digest;         // of the output file
+} TResult;
+
+// A fixed sequence, so the generated inputs, and so the outputs, are the same on every run.
+class Random {
+public:
+    uint32_t next() {
+        _state ^= _state << 13;
+        _state ^= _state >> 17;
+        _state ^= _state << 5;
+        return _state;
+    }
+    
+private:
+    uint32_t _state = 2463534242;
+};
+
+template <typename T>
+static void put(std::ostream &os, const T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) os.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+// MARK: - Images
+
+/*
+ Pixels are runs of a random color of random length, so the image is neither all
+ one color nor noise.
+ */
+static void writeBMP(const fs::path &path, const uint32_t width, const uint32_t height, const uint16_t bpp) {
+    Random random;
+    uint32_t colors = bpp <= 8 ? 1u << bpp : 0;
+    uint32_t rowSize = ((width * bpp + 31) / 32) * 4;
+    uint32_t offset = 14 + 40 + colors * 4;
+    
+    std::ofstream os(path, std::ios::binary);
+    os.write("BM", 2);
+    put<uint32_t>(os, offset + rowSize * height);
+    put<uint32_t>(os, 0);
+    put<uint32_t>(os, offset);
+    
+    put<uint32_t>(os, 40);
+    put<int32_t>(os, width);
+    put<int32_t>(os, height);
+    put<uint16_t>(os, 1);
+    put<uint16_t>(os, bpp);
+    put<uint32_t>(os, 0);
+    put<uint32_t>(os, rowSize * height);
+    put<uint32_t>(os, 2835);
+    put<uint32_t>(os, 2835);
+    put<uint32_t>(os, colors);
+    put<uint32_t>(os, colors);
+    
+    for (uint32_t i = 0; i < colors; ++i) put<uint32_t>(os, random.next() & 0xFFFFFF);
+    
+    uint32_t color = 0, run = 0;
+    std::vector<uint8_t> row(rowSize);
+    for (uint32_t y = 0; y < height; ++y) {
+        std::fill(row.begin(), row.end(), 0);
+        for (uint32_t x = 0; x < width; ++x) {
+            if (run-- == 0) {
+                color = random.next();
+                run = random.next() % 16;
+            }
+            uint32_t bit = x * bpp;
+            switch (bpp) {
+                case 1:
+                case 4:
+                case 8:
+                    row[bit / 8] |= (color & ((1u << bpp) - 1)) << (8 - bpp - bit % 8);
+                    break;
+                default:
+                    for (uint32_t i = 0; i < bpp / 8u; ++i) row[bit / 8 + i] = (color >> (i * 8)) & 0xFF;
+                    break;
+            }
+        }
+        os.write(reinterpret_cast<const char *>(row.data()), rowSize);
+    }
+}
+
+static void writePBM(const fs::path &path, const uint32_t width, const uint32_t height) {
+    Random random;
+    std::ofstream os(path, std::ios::binary);
+    os << "P4\n" << width << "\n" << height << "\n";
+    for (uint32_t i = 0; i < (width + 7) / 8 * height; ++i) os.put(static_cast<char>(random.next() & 0xFF));
+}
+
+// MARK: - Fonts
+
+static void writeAdafruitFont(const fs::path &path, const int glyphs, const int size) {
+    Random random;
+    std::ofstream os(path);
+    int bytes = (size * size + 7) / 8;
+    
+    os << "const uint8_t BenchBitmaps[] PROGMEM = {\n";
+    for (int i = 0; i < glyphs * bytes; ++i) {
+        os << (i % 16 ? " " : "  ") << "0x" << std::uppercase << std::hex << std::setfill('0') << std::setw(2) << (random.next() & 0xFF)
+           << (i + 1 < glyphs * bytes ? "," : "") << (i % 16 == 15 ? "\n" : "");
+    }
+    os << std::dec << std::setfill(' ') << " };\n\n";
+    
+    os << "const GFXglyph BenchGlyphs[] PROGMEM = {\n";
+    for (int i = 0; i < glyphs; ++i) {
+        os << "  { " << std::setw(5) << i * bytes << ", " << size << ", " << size << ", " << size + 1 << ", 0, " << -size << " }"
+           << (i + 1 < glyphs ? "," : "") << "   // 0x" << std::hex << i << std::dec << "\n";
+    }
+    os << " };\n\n";
+    
+    os << "const GFXfont Bench PROGMEM = {\n"
+       << "  (uint8_t  *)BenchBitmaps,\n"
+       << "  (GFXglyph *)BenchGlyphs,\n"
+       << "  0x00, 0x" << std::hex << glyphs - 1 << std::dec << ", " << size + 2 << " };\n";
+}
+
+// MARK: - Notes
+
+static void writePict(std::ostream &os, Random &random, const int width, const int height) {
+    os << "{\\pict\\picw" << width << "\\pich" << height << "\\align1 ";
+    for (int i = 0; i < width * height; ++i) {
+        if (i % width == 0) os << "\n";
+        os << std::uppercase << std::hex << std::setfill('0') << std::setw(4) << (random.next() & 0x7FFF);
+    }
+    os << std::dec << std::setfill(' ') << "}\n";
+}
+
+static void writeNTF(const fs::path &path, const int picts, const int height) {
+    Random random;
+    std::ofstream os(path);
+    for (int i = 0; i < picts; ++i) {
+        os << "\\qc\\fs22\\b Picture " << i + 1 << "\\b0\\fs16\\ql\n"
+           << "Some \\i italic\\i0, \\ul underlined\\ul0 and \\cf#7C00 colored\\cf0  text before the picture.\n";
+        writePict(os, random, 35, height);
+    }
+}
+
+static void writeMarkdown(const fs::path &path, const int picts, const int height) {
+    Random random;
+    std::ofstream os(path);
+    for (int i = 0; i < picts; ++i) {
+        os << "# Picture " << i + 1 << "\n\n"
+           << "Some *italic*, **bold** and `code` text before the picture.\n\n"
+           << "- First item\n"
+           << "- Second item\n\n";
+        writePict(os, random, 35, height);
+        os << "\n";
+    }
+}
+
+// MARK: - Running
+
+/*
+ Runs `tool` within the directory of `input`, returning its exit status and
+ setting `rss` to its peak resident set size in kilobytes.
+ */
+static int run(const fs::path &tool, const fs::path &input, const std::vector<std::string> &arguments, long long &rss) {
+    std::vector<std::string> args = {tool.string(), input.filename().string()};
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        std::vector<char *> argv;
+        for (auto &arg : args) argv.push_back(arg.data());
+        argv.push_back(nullptr);
+        
+        if (chdir(input.parent_path().c_str()) != 0) _exit(127);
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) dup2(null, STDERR_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    
+    int status = 0;
+    struct rusage usage = {};
+    if (wait4(pid, &status, 0, &usage) < 0) return -1;
+    
+#ifdef __APPLE__
+    rss = usage.ru_maxrss / 1024;
+#else
+    rss = usage.ru_maxrss;
+#endif
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Reads the phase times from a --profile-json report, keyed by phase name.
+static std::map<std::string, long long> readProfile(const fs::path &path) {
+    std::ifstream is(path);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    std::string json = ss.str();
+    
+    std::map<std::string, long long> stages;
+    std::regex stage(R"x("stage": *"([^"]+)"[^}]*"time_ns": *(\d+))x");
+    for (auto it = std::sregex_iterator(json.begin(), json.end(), stage); it != std::sregex_iterator(); ++it) {
+        stages[(*it)[1]] = std::stoll((*it)[2]);
+    }
+    return stages;
+}
+
+// FNV-1a, 64-bit.
+static std::string digest(const fs::path &path) {
+    std::ifstream is(path, std::ios::binary);
+    uint64_t hash = 0xcbf29ce484222325;
+    char buffer[65536];
+    while (is.read(buffer, sizeof(buffer)) || is.gcount()) {
+        for (std::streamsize i = 0; i < is.gcount(); ++i) {
+            hash ^= static_cast<uint8_t>(buffer[i]);
+            hash *= 0x100000001b3;
+        }
+    }
+    std::ostringstream os;
+    os << std::hex << std::setfill('0') << std::setw(16) << hash;
+    return os.str();
+}
+
+// The best of `repeat` runs is kept for each phase.
+static bool measure(const fs::path &tool, const TWorkload &workload, const fs::path &scratch, const int repeat, TResult &result) {
+    result.name = workload.name;
+    
+    auto profile = fs::absolute(scratch / (workload.name + ".json"));
+    auto output = fs::absolute(scratch / (workload.name + ".out" + workload.extension));
+    
+    auto best = [](long long &best, const long long value) {
+        if (best == 0 || value < best) best = value;
+    };
+    
+    for (int n = 0; n < repeat; ++n) {
+        long long rss = 0;
+        fs::remove(profile);
+        fs::remove(output);
+        if (run(tool, workload.input, {"-o", output.string(), "--profile-json", profile.string()}, rss) != 0 || !fs::exists(profile)) {
+            std::cerr << "❌ error: " << workload.name << " failed to convert.\n";
+            return false;
+        }
+        result.rss = std::max(result.rss, rss);
+        
+        auto stages = readProfile(profile);
+        best(result.load, stages["load"]);
+        best(result.convert, stages["convert"]);
+        best(result.emit, stages["emit"]);
+    }
+    
+    result.digest = digest(output);
+    return true;
+}
+
+// MARK: - Golden Digests
+
+static std::map<std::string, std::string> readGolden(const fs::path &path) {
+    std::map<std::string, std::string> golden;
+    std::ifstream is(path);
+    std::string name, digest;
+    while (is >> name >> digest) golden[name] = digest;
+    return golden;
+}
+
+static void writeGolden(const fs::path &path, const std::vector<TResult> &results) {
+    std::ofstream os(path);
+    for (const TResult &result : results) os << result.name << " " << result.digest << "\n";
+}
+
+static void writeResults(std::ostream &os, const std::vector<TResult> &results) {
+    os << "{\n  \"workloads\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const TResult &result = results[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"name\": \"" << result.name << "\""
+           << ", \"load_ns\": " << result.load
+           << ", \"convert_ns\": " << result.convert
+           << ", \"emit_ns\": " << result.emit
+           << ", \"peak_rss_kb\": " << result.rss
+           << ", \"digest\": \"" << result.digest << "\"}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+// MARK: - Command Line
+
+static void help(void) {
+    std::cout
+    << "Usage: bench [options]\n"
+    << "\n"
+    << "Options:\n"
+    << "  --grob <path>           The grob tool to run, skipped if not given.\n"
+    << "  --hpfont <path>         The hpfont tool to run, skipped if not given.\n"
+    << "  --hpnote <path>         The hpnote tool to run, skipped if not given.\n"
+    << "  --scratch <dir>         Directory for generated inputs and outputs (default: build/bench).\n"
+    << "  --repeat <n>            Runs of each workload, keeping the best time (default: 3).\n"
+    << "  --golden <file>         Fail if any output differs from the digests in <file>.\n"
+    << "  --update-golden         Write the digests of the outputs to the --golden file.\n"
+    << "  --output <file>         Write the results as JSON to <file>.\n"
+    << "  --large <n>             Width and height of the largest images (default: 1024).\n";
+}
+
+int main(int argc, const char **argv) {
+    std::map<std::string, fs::path> tools;
+    fs::path scratch = "build/bench", golden, output;
+    int repeat = 3;
+    uint32_t large = 1024;
+    bool update = false;
+    
+    for (int n = 1; n < argc; ++n) {
+        std::string args(argv[n]);
+        
+        auto value = [&]() -> std::string {
+            if (++n >= argc) {
+                std::cerr << "❌ error: " << args << " requires a value.\n";
+                exit(1);
+            }
+            return argv[n];
+        };
+        
+        if (args == "--help") { help(); return 0; }
+        if (args == "--grob" || args == "--hpfont" || args == "--hpnote") { tools[args.substr(2)] = fs::absolute(value()); continue; }
+        if (args == "--scratch") { scratch = value(); continue; }
+        if (args == "--repeat") { repeat = std::max(1, std::atoi(value().c_str())); continue; }
+        if (args == "--golden") { golden = value(); continue; }
+        if (args == "--update-golden") { update = true; continue; }
+        if (args == "--output") { output = value(); continue; }
+        if (args == "--large") { large = std::max(64, std::atoi(value().c_str())) / 64 * 64; continue; }
+        std::cerr << "❌ error: unknown option " << args << ".\n";
+        return 1;
+    }
+    
+    if (tools.empty()) {
+        help();
+        return 1;
+    }
+    
+    // A check against digests that were never recorded would pass whatever the output.
+    if (!golden.empty() && !update && !fs::exists(golden)) {
+        std::cerr << "❌ error: no golden digests in " << golden.string() << ", record them first with --update-golden.\n";
+        return 1;
+    }
+    
+    fs::path inputs = scratch / "inputs";
+    fs::create_directories(inputs);
+    std::vector<TWorkload> workloads;
+    
+    if (tools.contains("grob")) {
+        for (const uint32_t size : {64u, 256u, large}) {
+            for (const uint16_t bpp : {1, 4, 8, 16, 32}) {
+                std::string name = "grob-bmp" + std::to_string(bpp) + "-" + std::to_string(size);
+                writeBMP(inputs / (name + ".bmp"), size, size, bpp);
+                workloads.push_back({name, "grob", fs::absolute(inputs / (name + ".bmp")), ".prgm"});
+            }
+            std::string name = "grob-pbm-" + std::to_string(size);
+            writePBM(inputs / (name + ".pbm"), size, size);
+            workloads.push_back({name, "grob", fs::absolute(inputs / (name + ".pbm")), ".prgm"});
+        }
+    }
+    
+    if (tools.contains("hpfont")) {
+        for (const auto &shape : std::vector<std::pair<int, int>>{{95, 8}, {256, 8}, {128, 16}}) {
+            std::string name = "hpfont-" + std::to_string(shape.first) + "x" + std::to_string(shape.second);
+            writeAdafruitFont(inputs / (name + ".h"), shape.first, shape.second);
+            workloads.push_back({name, "hpfont", fs::absolute(inputs / (name + ".h")), ".prgm"});
+        }
+    }
+    
+    if (tools.contains("hpnote")) {
+        for (const auto &shape : std::vector<std::pair<int, int>>{{4, 32}, {16, 128}, {32, 512}}) {
+            std::string suffix = std::to_string(shape.first) + "x" + std::to_string(shape.second);
+            writeNTF(inputs / ("hpnote-ntf-" + suffix + ".ntf"), shape.first, shape.second);
+            workloads.push_back({"hpnote-ntf-" + suffix, "hpnote", fs::absolute(inputs / ("hpnote-ntf-" + suffix + ".ntf")), ".hpnote"});
+            writeMarkdown(inputs / ("hpnote-md-" + suffix + ".md"), shape.first, shape.second);
+            workloads.push_back({"hpnote-md-" + suffix, "hpnote", fs::absolute(inputs / ("hpnote-md-" + suffix + ".md")), ".hpnote"});
+        }
+    }
+    
+    std::vector<TResult> results;
+    for (const auto &workload : workloads) {
+        TResult result;
+        if (!measure(tools[workload.tool], workload, scratch, repeat, result)) return 1;
+        results.push_back(result);
+    }
+    
+    auto expected = (!golden.empty() && !update) ? readGolden(golden) : std::map<std::string, std::string>();
+    bool changed = false;
+    
+    std::cout << std::left << std::setw(24) << "Workload" << std::right
+              << std::setw(10) << "Load ms"
+              << std::setw(12) << "Convert ms"
+              << std::setw(10) << "Emit ms"
+              << std::setw(13) << "Peak RSS KB"
+              << "  Output\n";
+    for (const TResult &result : results) {
+        std::string status = "";
+        auto it = expected.find(result.name);
+        if (it != expected.end()) {
+            status = it->second == result.digest ? "identical" : "CHANGED";
+            if (it->second != result.digest) changed = true;
+        } else if (!golden.empty() && !update) {
+            status = "NOT RECORDED";
+            changed = true;
+        }
+        std::cout << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << result.load / 1e6
+                  << std::setw(12) << result.convert / 1e6
+                  << std::setw(10) << result.emit / 1e6
+                  << std::setw(13) << result.rss
+                  << "  " << status << "\n";
+    }
+    
+    if (update && !golden.empty()) writeGolden(golden, results);
+    
+    if (!output.empty()) {
+        std::ofstream os(output);
+        writeResults(os, results);
+    }
+    
+    if (changed) {
+        std::cerr << "❌ Output differs from, or is missing from, the golden digests in " << golden.filename() << ".\n";
+        return 1;
+    }
+    return 0;
+}
@@ -56,6 +56,29 @@ namespace std::filesystem {
     }
 }
 
+// Runs `f`, adding the time it takes to `total`.
+template <typename F>
+static auto timed(long long &total, F &&f) {
+    Timer timer;
+    auto result = f();
+    total += timer.elapsed();
+    return result;
+}
+
+// Writes the time spent loading, converting and emitting, in the JSON form used by hpppl+ --profile-json.
+static void writeProfile(const fs::path &path, const long long elapsed, const long long load, const long long convert, const long long emit) {
+    std::ofstream os(path);
+    if (!os.is_open()) {
+        std::cerr << "❌ Unable to create file " << path.filename() << ".\n";
+        return;
+    }
+    os << "{\n  \"elapsed_ns\": " << elapsed << ",\n  \"stages\": [\n"
+       << "    {\"stage\": \"load\", \"calls\": 1, \"time_ns\": " << load << "},\n"
+       << "    {\"stage\": \"convert\", \"calls\": 1, \"time_ns\": " << convert << "},\n"
+       << "    {\"stage\": \"emit\", \"calls\": 1, \"time_ns\": " << emit << "}\n"
+       << "  ]\n}\n";
+}
+
 // MARK: - Command Line
 
 void help(void)
@@ -67,6 +90,7 @@ void help(void)
     << "Usage: " << COMMAND_NAME << " <input-file>\n"
     << "  --plain-fallback           Includes the plain-text carbon copy fallback used for recovery"
     << "                             if the formatted content is unreadable.\n"
+    << "  --profile-json <file>      Write the time spent loading, converting and emitting as JSON.\n"
     << "\n"
     << "Additional Commands:\n"
     << "  " << COMMAND_NAME << " {--version | --help}\n"
@@ -159,7 +183,7 @@ int main(int argc, const char * argv[]) {
     Type type = Type::AUTO;
     
     std::string prefix, sufix, name;
-    fs::path inpath, outpath;
+    fs::path inpath, outpath, profilePath;
     bool verbose = false;
     bool cc = false;
     bool html = false;
@@ -183,6 +207,15 @@ int main(int argc, const char * argv[]) {
                 continue;
             }
             
+            if (args == "--profile-json") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(0);
+                }
+                profilePath = fs::expand_tilde(argv[n]);
+                continue;
+            }
+            
             if ( args == "--plain-fallback" ) {
                 cc = true;
                 continue;
@@ -235,6 +268,7 @@ int main(int argc, const char * argv[]) {
     
     // Start measuring time
     Timer timer;
+    long long loadTime = 0;
     
     std::u16string out;
     
@@ -244,14 +278,14 @@ int main(int argc, const char * argv[]) {
     if (out_extension == ".html") html = true;
     
     if (in_extension == ".md") {
-        std::string md = utf::load(inpath);
+        std::string md = timed(loadTime, [&] { return utf::load(inpath); });
         std::string ntf = ntf::markdownToNTF(md);
         ntf::defaultColorTable();
         out = hpnote::ntf_to_hpnote(ntf, cc);
     }
     
     if (in_extension == ".ntf") {
-        std::string ntf = utf::load(inpath);
+        std::string ntf = timed(loadTime, [&] { return utf::load(inpath); });
         ntf::defaultColorTable();
         if (html)
             out = utf::to_u16string(html::ntf_to_html(ntf));
@@ -260,31 +294,31 @@ int main(int argc, const char * argv[]) {
     }
     
     if (in_extension == ".rtf") {
-        std::string rtf = utf::load(inpath);
+        std::string rtf = timed(loadTime, [&] { return utf::load(inpath); });
         std::string ntf = ntf::richTextToNTF(rtf);
         out = hpnote::ntf_to_hpnote(ntf, cc);
     }
     
     if (in_extension == ".txt") {
-        out = utf::to_u16string(utf::load(inpath));
+        out = utf::to_u16string(timed(loadTime, [&] { return utf::load(inpath); }));
     }
     
     if (in_extension == ".note") {
         auto bom = utf::bom(inpath);
         if (bom == utf::BOM::none) {
-            std::string ntf = utf::load(inpath);
+            std::string ntf = timed(loadTime, [&] { return utf::load(inpath); });
             if (html)
                 out = utf::to_u16string(html::ntf_to_html(ntf));
             else
                 out = hpnote::ntf_to_hpnote(ntf, cc);
         } else {
-            out = utf::to_u16string(utf::load(inpath, bom));
+            out = utf::to_u16string(timed(loadTime, [&] { return utf::load(inpath, bom); }));
         }
     }
     
     if (in_extension == ".hpnote" || in_extension == ".hpappnote") {
         if (out_extension == ".ntf" || outpath == "/dev/stdout" || type == Type::NTF || html) {
-            auto hpnote = utf::load(inpath, utf::BOM::none, true);
+            auto hpnote = timed(loadTime, [&] { return utf::load(inpath, utf::BOM::none, true); });
             std::u16string s = utf::to_u16string(hpnote);
             auto ntf = hpnote::to_ntf(s);
             if (html)
@@ -292,11 +326,13 @@ int main(int argc, const char * argv[]) {
             else
                 out = utf::to_u16string(ntf);
         } else {
-            auto s = utf::load(inpath, utf::BOM::none, false);
+            auto s = timed(loadTime, [&] { return utf::load(inpath, utf::BOM::none, false); });
             out = utf::to_u16string(s);
         }
     }
     
+    long long converted = timer.elapsed();
+    
     if (outpath == "/dev/stdout") {
         if (out.size() > 2)
             std::cout << utf::to_string(out);
@@ -323,6 +359,10 @@ int main(int argc, const char * argv[]) {
     // Stop measuring time and calculate the elapsed time.
     long long elapsed_time = timer.elapsed();
     
+    if (!profilePath.empty()) {
+        writeProfile(profilePath, elapsed_time, loadTime, converted - loadTime, elapsed_time - converted);
+    }
+    
     if (outpath == "/dev/stdout") {
         std::cerr << "Successfully converted " << inpath.filename() << " to NoteText\n";
     } else {
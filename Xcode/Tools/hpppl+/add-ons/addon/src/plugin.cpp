@@ -0,0 +1,63 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The add-on built as a shared library, loaded by hpppl+ in place of running it.
+
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "hpppl_addon.h"
+
+static void release(hpppl_addon_buffer *buffer) {
+    free(buffer->data);
+    buffer->data = nullptr;
+    buffer->length = 0;
+}
+
+static void fill(hpppl_addon_buffer *buffer, const std::string &str) {
+    buffer->data = static_cast<char *>(malloc(str.length()));
+    buffer->length = buffer->data ? str.length() : 0;
+    if (buffer->data) memcpy(buffer->data, str.data(), str.length());
+    buffer->release = release;
+}
+
+extern "C" int hpppl_addon_abi_version(void) {
+    return HPPPL_ADDON_ABI_VERSION;
+}
+
+extern "C" int hpppl_addon_convert(const char *path, const char *const *argv, hpppl_addon_buffer *out, hpppl_addon_buffer *err) {
+    std::ifstream inputFile(path);
+    
+    if (!inputFile.is_open()) {
+        fill(out, "");
+        fill(err, std::string("❓File ") + path + " not found.\n");
+        return 1;
+    }
+    
+    std::string content((std::istreambuf_iterator<char>(inputFile)),
+                        std::istreambuf_iterator<char>());
+    fill(out, content);
+    fill(err, "");
+    return 0;
+}
@@ -134,6 +134,20 @@ std::string replaceAll(std::string text,
     return text;
 }
 
+// Writes the time spent loading, converting and emitting, in the JSON form used by hpppl+ --profile-json.
+static void writeProfile(const fs::path &path, const long long elapsed, const long long load, const long long convert, const long long emit) {
+    std::ofstream os(path);
+    if (!os.is_open()) {
+        std::cerr << "❌ Unable to create file " << path.filename() << ".\n";
+        return;
+    }
+    os << "{\n  \"elapsed_ns\": " << elapsed << ",\n  \"stages\": [\n"
+       << "    {\"stage\": \"load\", \"calls\": 1, \"time_ns\": " << load << "},\n"
+       << "    {\"stage\": \"convert\", \"calls\": 1, \"time_ns\": " << convert << "},\n"
+       << "    {\"stage\": \"emit\", \"calls\": 1, \"time_ns\": " << emit << "}\n"
+       << "  ]\n}\n";
+}
+
 // MARK: - Command Line
 void help(void)
 {
@@ -148,6 +162,7 @@ void help(void)
     << "  -c <columns>               Number of columns.\n"
     << "  --pragma                   Include \"#pragma mode( separator(.,;) integer(h64) )\" line.\n"
     << "  --endian <le|be>           Endianes le(default).\n"
+    << "  --profile-json <file>      Write the time spent loading, converting and emitting as JSON.\n"
     << "\n"
     << "Additional Commands:\n"
     << "  " << COMMAND_NAME << " {--version | --help}\n"
@@ -221,7 +236,7 @@ fs::path resolveOutputPath(const fs::path& inpath, const fs::path& outpath) {
 // MARK: - Main
 int main(int argc, const char * argv[]) {
     std::string prefix, sufix, name;
-    fs::path inpath, outpath;
+    fs::path inpath, outpath, profilePath;
     
     int columns = 8;
     std::string grob("G0");
@@ -256,6 +271,15 @@ int main(int argc, const char * argv[]) {
             continue;
         }
         
+        if (args == "--profile-json") {
+            if ( ++n >= argc ) {
+                error();
+                exit(0);
+            }
+            profilePath = expandTilde(argv[n]);
+            continue;
+        }
+        
         if (args == "--data") {
             data = true;
             continue;
@@ -369,9 +393,13 @@ int main(int argc, const char * argv[]) {
 #endif
     if (ext == ".pbm") bitmap = pbm::load(inpath);
     
-    if (bitmap.bytes.empty()) {
+    bool raw = bitmap.bytes.empty();
+    if (raw) {
         lengthInBytes = loadBinaryFile(inpath.string().c_str(), bitmap);
-    } else {
+    }
+    long long loaded = timer.elapsed();
+    
+    if (!raw) {
         switch (bitmap.bpp) {
             case 1:
                 lengthInBytes = bitmap.width * bitmap.height / 8;
@@ -512,6 +540,8 @@ const ImageData image = {");
         
     }
 
+    long long converted = timer.elapsed();
+    
     if (outpath == "/dev/stdout") {
         std::cout << utf8;
     } else {
@@ -529,7 +559,7 @@ const ImageData image = {");
                 if (outpath_extension == ".hpprgm") {
                     hpprgm::write(outpath, utf8);
                 } else {
-                    std::wstring utf16 = utf::utf16(utf8);
+                    std::wstring utf16 = utf::to_wstring(utf8);
                     utf::save(outpath, utf16);
                 }
             } else {
@@ -548,6 +578,10 @@ const ImageData image = {");
     // Stop measuring time and calculate the elapsed time.
     long long elapsed_time = timer.elapsed();
     
+    if (!profilePath.empty()) {
+        writeProfile(profilePath, elapsed_time, loaded, converted - loaded, elapsed_time - converted);
+    }
+    
     // Display elasps time in secononds.
     if (elapsed_time / 1e9 < 1.0) {
         std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e6 << " milliseconds\n";
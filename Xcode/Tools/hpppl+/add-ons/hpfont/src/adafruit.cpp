@@ -26,6 +26,9 @@
 #include <fstream>
 #include "utf.hpp"
 
+using adafruit::TGlyph;
+using adafruit::TAdafruitFont;
+
 #if __cplusplus >= 202302L
     #include <bit>
     using std::byteswap;
@@ -56,14 +59,6 @@
     #error "C++11 or newer is required"
 #endif
 
-typedef struct {
-    uint16_t   bitmapOffset;    // Offset address into the bitmap data.
-    uint8_t    width, height;   // Bitmap dimensions in pixels.
-    uint8_t    xAdvance;        // Distance to advance cursor in the x-axis.
-    int8_t     dX;              // Used to position the glyph within the cell in the horizontal direction.
-    int8_t     dY;              // Distance from the baseline of the character to the top of the glyph.
-} TGlyph;
-
 typedef struct {
     uint8_t   *bitmap;          // Glyph bitmaps, concatenated.
     TGlyph    *glyph;           // Glyph array.
@@ -79,14 +74,6 @@ typedef struct {
  the last glyph in the font is always the last glyph entry.
  */
 
-typedef struct {
-    std::vector<uint8_t> data;
-    std::vector<TGlyph> glyphs;
-    uint8_t first;
-    uint8_t last;
-    uint8_t yAdvance;
-} TAdafruitFont;
-
 static int parseNumber(const std::string &str)
 {
     std::regex hexPattern("^0x[\\da-fA-F]+$");
@@ -102,7 +89,7 @@ static int parseNumber(const std::string &str)
     return 0;
 }
 
-static bool parseHAdafruitFont(const std::filesystem::path& path, TAdafruitFont &font)
+bool adafruit::load(const std::filesystem::path& path, TAdafruitFont &font)
 {
     std::ifstream infile;
     std::string utf8;
@@ -220,7 +207,7 @@ static std::string createPPLList(const void *data, const size_t lengthInBytes, c
     return os.str();
 }
 
-static std::string createPPLAdafruitFont(TAdafruitFont &adafruitFont, const std::string &name)
+std::string adafruit::convertAdafruitFontToPPL(TAdafruitFont &adafruitFont, const std::string &name)
 {
     std::ostringstream os;
     
@@ -244,15 +231,15 @@ std::string adafruit::convertAdafruitFontToPPL(const std::filesystem::path& inpa
     TAdafruitFont adafruitFont;
     std::string str;
     
-    if (!parseHAdafruitFont(inpath, adafruitFont)) {
+    if (!load(inpath, adafruitFont)) {
         std::cerr << "Failed to find valid Adafruit Font data.\n";
         exit(2);
     }
 
     if (name == "*")
-        str = createPPLAdafruitFont(adafruitFont, inpath.stem().string());
+        str = convertAdafruitFontToPPL(adafruitFont, inpath.stem().string());
     else
-        str = createPPLAdafruitFont(adafruitFont, name);
+        str = convertAdafruitFontToPPL(adafruitFont, name);
     
     return str;
 }
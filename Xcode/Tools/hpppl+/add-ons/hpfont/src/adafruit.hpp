@@ -24,7 +24,31 @@
 
 #include <iostream>
 #include <filesystem>
+#include <vector>
+#include <cstdint>
 
 namespace adafruit {
+    typedef struct {
+        uint16_t   bitmapOffset;    // Offset address into the bitmap data.
+        uint8_t    width, height;   // Bitmap dimensions in pixels.
+        uint8_t    xAdvance;        // Distance to advance cursor in the x-axis.
+        int8_t     dX;              // Used to position the glyph within the cell in the horizontal direction.
+        int8_t     dY;              // Distance from the baseline of the character to the top of the glyph.
+        uint8_t    unused = 0;      // The top byte of the glyph in PPL, written as is so never left undefined.
+    } TGlyph;
+    
+    typedef struct {
+        std::vector<uint8_t> data;
+        std::vector<TGlyph> glyphs;
+        uint8_t first;
+        uint8_t last;
+        uint8_t yAdvance;
+    } TAdafruitFont;
+    
+    // Reads the bitmap data, glyph table and font record of an Adafruit GFX font header.
+    bool load(const std::filesystem::path& path, TAdafruitFont &font);
+    
+    // PPL for a loaded font, mirroring the bits of its bitmap data in place as PPL expects them.
+    std::string convertAdafruitFontToPPL(TAdafruitFont &adafruitFont, const std::string &name);
     std::string convertAdafruitFontToPPL(const std::filesystem::path& inpath, const std::string name);
 }
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include <regex>
+#include <fstream>
 
 #include "../../../src/extensions.hpp"
 #include "../../../src/timer.hpp"
@@ -53,6 +54,7 @@ void help(void) {
     << "  -o <output-file>        Specify the filename for generated .hpprgm file.\n"
     << "  -c or --compress        Specify if the PPL code should be compressed.\n"
     << "  -n or --name            Specify the variable name to use.\n"
+    << "  --profile-json <file>   Write the time spent loading, converting and emitting as JSON.\n"
     << "\n"
     << "Additional Commands:\n"
     << "  " << COMMAND_NAME << " {--version | --help }\n"
@@ -251,6 +253,20 @@ fs::path resolveOutputPath(const fs::path& inpath, const fs::path& outpath) {
     return path;
 }
 
+// Writes the time spent loading, converting and emitting, in the JSON form used by hpppl+ --profile-json.
+static void writeProfile(const fs::path &path, const long long elapsed, const long long load, const long long convert, const long long emit) {
+    std::ofstream os(path);
+    if (!os.is_open()) {
+        std::cerr << "❌ Unable to create file " << path.filename() << ".\n";
+        return;
+    }
+    os << "{\n  \"elapsed_ns\": " << elapsed << ",\n  \"stages\": [\n"
+       << "    {\"stage\": \"load\", \"calls\": 1, \"time_ns\": " << load << "},\n"
+       << "    {\"stage\": \"convert\", \"calls\": 1, \"time_ns\": " << convert << "},\n"
+       << "    {\"stage\": \"emit\", \"calls\": 1, \"time_ns\": " << emit << "}\n"
+       << "  ]\n}\n";
+}
+
 // MARK: - Main
 
 int main(int argc, const char **argv)
@@ -270,7 +286,7 @@ int main(int argc, const char **argv)
     
     std::string args(argv[0]);
     std::string name, prefix, sufix;
-    std::filesystem::path inpath, outpath;
+    std::filesystem::path inpath, outpath, profilePath;
 
     for( int n = 1; n < argc; n++ ) {
         if (*argv[n] == '-') {
@@ -285,6 +301,15 @@ int main(int argc, const char **argv)
                 continue;
             }
             
+            if (args == "--profile-json") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(0);
+                }
+                profilePath = fs::expand_tilde(argv[n]);
+                continue;
+            }
+            
             if ( args == "-c" || args == "--compress" ) {
                 minify = true;
                 continue;
@@ -345,7 +370,14 @@ int main(int argc, const char **argv)
     // Start measuring time
     Timer timer;
    
-    std::string output = adafruit::convertAdafruitFontToPPL(inpath, name);
+    adafruit::TAdafruitFont font;
+    if (!adafruit::load(inpath, font)) {
+        std::cerr << "Failed to find valid Adafruit Font data.\n";
+        exit(2);
+    }
+    long long loaded = timer.elapsed();
+    
+    std::string output = adafruit::convertAdafruitFontToPPL(font, name == "*" ? inpath.stem().string() : name);
     
     if (minify) {
         output = regex_replace(output, std::regex(R"(#0+)"), "#");
@@ -362,11 +394,13 @@ int main(int argc, const char **argv)
         output = replaceAll(output, "}", "]");
     }
     
+    long long converted = timer.elapsed();
+    
     if (outpath == "/dev/stdout") {
         std::cout << output;
         std::cerr << '\n';
     } else {
-        if (!utf::save(outpath, utf::utf16(output), utf::BOMle)) {
+        if (!utf::save(outpath, utf::to_wstring(output), utf::BOM::le)) {
             std::cerr << "❌ Unable to create file " << outpath.filename() << ".\n";
             return 0;
         }
@@ -377,6 +411,10 @@ int main(int argc, const char **argv)
     // Stop measuring time and calculate the elapsed time.
     long long elapsed_time = timer.elapsed();
     
+    if (!profilePath.empty()) {
+        writeProfile(profilePath, elapsed_time, loaded, converted - loaded, elapsed_time - converted);
+    }
+    
     // Display elasps time in secononds.
     if (elapsed_time / 1e9 < 1.0) {
         std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e6 << " milliseconds\n";
@@ -0,0 +1,520 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ Benchmark harness for hpppl+.
+ 
+ Generates synthetic PPL+ sources of configurable size and shape, and runs them,
+ along with the real Examples/ and Apps/ projects as fixed workloads, through a
+ built hpppl+. Each stage is timed by the tool itself using --profile-json, and
+ the peak resident set size of each run is taken from the operating system.
+ 
+ Results are written as JSON, and compared against a baseline JSON when given
+ one, failing if any workload has become slower than the tolerance allows.
+ 
+ Timings only compare on the machine that made them, so no baseline is kept in
+ the repository: `make bench-baseline` records one, before the first `make bench`.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <filesystem>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+namespace fs = std::filesystem;
+
+typedef struct TShape {
+    long lines = 2000;          // approximate number of lines of code in the main file
+    long aliases = 50;
+    long regexps = 20;
+    long dictionaries = 5;
+    long includes = 4;
+    long python = 2;
+    long depth = 3;             // nesting depth of the control structures within each function
+} TShape;
+
+typedef struct TWorkload {
+    std::string name;
+    fs::path input;
+    long lines = 0;
+} TWorkload;
+
+typedef struct TResult {
+    std::string name;
+    long lines = 0;
+    long long translate = 0;    // nanoseconds
+    long long minify = 0;
+    long long reformat = 0;
+    long long write = 0;
+    long long rss = 0;          // peak resident set size in kilobytes
+    
+    double linesPerSecond() const {
+        return translate ? lines * 1e9 / translate : 0;
+    }
+} TResult;
+
+// MARK: - Synthetic Corpus
+
+static void writeFunction(std::ostream &os, const std::string &name, const std::string &real, const TShape &shape, long &lines) {
+    os << "alias " << name << " := " << real << ";\n"
+       << "local " << name << "(a, b)\n"
+       << "begin\n"
+       << "  var total := 0;\n";
+    lines += 4;
+    
+    std::string indent = "  ";
+    for (long level = 0; level < shape.depth; ++level) {
+        switch (level % 3) {
+            case 0:
+                os << indent << "for i" << level << " from 1 to a do\n";
+                break;
+            case 1:
+                os << indent << "if total > b then\n";
+                break;
+            default:
+                os << indent << "while total < a * " << level << " do\n";
+                break;
+        }
+        indent += "  ";
+        os << indent << "total := total + " << level << ";\n";
+        lines += 2;
+    }
+    for (long level = shape.depth; level > 0; --level) {
+        indent.resize(indent.length() - 2);
+        os << indent << "end;\n";
+        lines++;
+    }
+    
+    os << "  return total;\n"
+       << "end;\n\n";
+    lines += 3;
+}
+
+static void generate(const fs::path &dir, const TShape &shape) {
+    fs::create_directories(dir);
+    
+    for (long i = 0; i < shape.includes; ++i) {
+        std::ofstream os(dir / ("include" + std::to_string(i) + ".hppplplus"));
+        long lines = 0;
+        os << "alias Include" << i << "::Value := iv" << i << ";\n"
+           << "regex `\\bincludeRule" << i << "\\b` " << i << "\n\n";
+        for (long n = 0; lines < shape.lines / (shape.includes * 4); ++n) {
+            writeFunction(os, "Include" + std::to_string(i) + "::Function" + std::to_string(n), "i" + std::to_string(i) + "f" + std::to_string(n), shape, lines);
+        }
+    }
+    
+    std::ofstream os(dir / "main.hppplplus");
+    long lines = 0;
+    
+    os << "#pragma mode( separator(.,;) integer(h32) )\n\n";
+    
+    for (long i = 0; i < shape.includes; ++i) {
+        os << "{$INCLUDE include" << i << ".hppplplus}\n";
+    }
+    
+    for (long i = 0; i < shape.regexps; ++i) {
+        os << "regex `\\bbenchRule" << i << "\\(([^)]*)\\)` (($1) * " << i + 1 << ")\n";
+    }
+    
+    for (long i = 0; i < shape.aliases; ++i) {
+        os << "alias Bench::Value" << i << " := bv" << i << ";\n";
+    }
+    
+    for (long i = 0; i < shape.dictionaries; ++i) {
+        os << "dictionary ";
+        for (long n = 0; n < 8; ++n) {
+            os << (n ? ", " : "") << "Entry" << n << " := " << n * (i + 1);
+        }
+        os << " @Dictionary" << i << ";\n";
+    }
+    os << "\n";
+    
+    for (long i = 0; i < shape.python; ++i) {
+        os << "#PYTHON Python" << i << "(first:x,second:y)\n"
+           << "from sys import argv\n"
+           << "print(int(x) * int(y) + " << i << ")\n"
+           << "#END\n\n";
+    }
+    
+    for (long n = 0; lines < shape.lines; ++n) {
+        std::string name = "Bench::Function" + std::to_string(n);
+        writeFunction(os, name, "f" + std::to_string(n), shape, lines);
+        
+        // Uses of the aliases, regex rules and dictionaries defined above.
+        os << "export Bench::Entry" << n << "()\n"
+           << "begin\n"
+           << "  local result := " << name << "(10, 20);\n"
+           << "  local label := \"entry " << n << "\";\n";
+        if (shape.aliases) os << "  Bench::Value" << n % shape.aliases << " := result;\n";
+        if (shape.regexps) os << "  result := benchRule" << n % shape.regexps << "(result + 1);\n";
+        if (shape.dictionaries) os << "  result := result + Dictionary" << n % shape.dictionaries << ".Entry" << n % 8 << ";\n";
+        if (shape.includes) os << "  result := result + Include" << n % shape.includes << "::Value;\n";
+        os << "  return result; // returns the sum\n"
+           << "end;\n\n";
+        lines += 10;
+    }
+}
+
+// MARK: - Running
+
+static long countLines(const fs::path &dir) {
+    long lines = 0;
+    for (const auto &entry : fs::directory_iterator(dir)) {
+        auto extension = entry.path().extension();
+        if (extension != ".hppplplus" && extension != ".hpppl") continue;
+        std::ifstream is(entry.path());
+        lines += std::count(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>(), '\n');
+    }
+    return lines;
+}
+
+/*
+ Runs the tool within the directory of `input`, returning its exit status and
+ setting `rss` to its peak resident set size in kilobytes.
+ */
+static int run(const fs::path &tool, const fs::path &input, const std::vector<std::string> &arguments, long long &rss) {
+    std::vector<std::string> args = {tool.string(), input.filename().string()};
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        std::vector<char *> argv;
+        for (auto &arg : args) argv.push_back(arg.data());
+        argv.push_back(nullptr);
+        
+        if (chdir(input.parent_path().c_str()) != 0) _exit(127);
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) dup2(null, STDERR_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    
+    int status = 0;
+    struct rusage usage = {};
+    if (wait4(pid, &status, 0, &usage) < 0) return -1;
+    
+#ifdef __APPLE__
+    rss = usage.ru_maxrss / 1024;
+#else
+    rss = usage.ru_maxrss;
+#endif
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Reads the stage times from a --profile-json report, keyed by stage name.
+static std::map<std::string, long long> readProfile(const fs::path &path, long long &elapsed) {
+    std::ifstream is(path);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    std::string json = ss.str();
+    
+    std::map<std::string, long long> stages;
+    std::smatch match;
+    if (std::regex_search(json, match, std::regex(R"x("elapsed_ns": *(\d+))x"))) elapsed = std::stoll(match[1]);
+    
+    std::regex stage(R"x("stage": *"([^"]+)"[^}]*"time_ns": *(\d+))x");
+    for (auto it = std::sregex_iterator(json.begin(), json.end(), stage); it != std::sregex_iterator(); ++it) {
+        stages[(*it)[1]] = std::stoll((*it)[2]);
+    }
+    return stages;
+}
+
+/*
+ Runs a workload three ways, as minify and reformat are alternatives: plainly to
+ an .hpprgm for the translation and write times, then minified, then reformatted.
+ The best of `repeat` runs is kept for each time.
+ */
+static bool measure(const fs::path &tool, const TWorkload &workload, const fs::path &scratch, const int repeat, TResult &result) {
+    result.name = workload.name;
+    result.lines = workload.lines;
+    result.translate = result.minify = result.reformat = result.write = 0;
+    
+    std::string stem = workload.name;
+    std::replace(stem.begin(), stem.end(), '/', '-');
+    auto profile = fs::absolute(scratch / (stem + ".json"));
+    auto output = fs::absolute(scratch / (stem + ".hpprgm"));
+    
+    auto best = [](long long &best, const long long value) {
+        if (best == 0 || value < best) best = value;
+    };
+    
+    for (int n = 0; n < repeat; ++n) {
+        for (const std::string mode : {"", "-c", "-r"}) {
+            std::vector<std::string> args = {"-o", output.string(), "--no-cache", "--profile-json", profile.string()};
+            if (!mode.empty()) args.push_back(mode);
+            
+            long long rss = 0;
+            fs::remove(profile);
+            if (run(tool, workload.input, args, rss) != 0 || !fs::exists(profile)) {
+                std::cerr << "❌ error: " << workload.name << " failed to translate.\n";
+                return false;
+            }
+            result.rss = std::max(result.rss, rss);
+            
+            long long elapsed = 0;
+            auto stages = readProfile(profile, elapsed);
+            if (mode.empty()) {
+                best(result.translate, elapsed - stages["minify"] - stages["reformat"] - stages["write"]);
+                best(result.write, stages["write"]);
+            }
+            if (mode == "-c") best(result.minify, stages["minify"]);
+            if (mode == "-r") best(result.reformat, stages["reformat"]);
+        }
+    }
+    return true;
+}
+
+// MARK: - Results
+
+static void writeResults(std::ostream &os, const std::vector<TResult> &results) {
+    os << "{\n  \"workloads\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const TResult &result = results[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"name\": \"" << result.name << "\""
+           << ", \"lines\": " << result.lines
+           << ", \"translate_ns\": " << result.translate
+           << ", \"minify_ns\": " << result.minify
+           << ", \"reformat_ns\": " << result.reformat
+           << ", \"write_ns\": " << result.write
+           << ", \"lines_per_second\": " << static_cast<long long>(result.linesPerSecond())
+           << ", \"peak_rss_kb\": " << result.rss << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+static std::map<std::string, TResult> readResults(const fs::path &path) {
+    std::map<std::string, TResult> results;
+    std::ifstream is(path);
+    std::string line;
+    
+    std::regex field(R"x("(\w+)": *("[^"]*"|\d+))x");
+    while (getline(is, line)) {
+        TResult result;
+        for (auto it = std::sregex_iterator(line.begin(), line.end(), field); it != std::sregex_iterator(); ++it) {
+            std::string key = (*it)[1], value = (*it)[2];
+            if (key == "name") result.name = value.substr(1, value.length() - 2);
+            if (key == "lines") result.lines = std::stol(value);
+            if (key == "translate_ns") result.translate = std::stoll(value);
+            if (key == "minify_ns") result.minify = std::stoll(value);
+            if (key == "reformat_ns") result.reformat = std::stoll(value);
+            if (key == "write_ns") result.write = std::stoll(value);
+            if (key == "peak_rss_kb") result.rss = std::stoll(value);
+        }
+        if (!result.name.empty()) results[result.name] = result;
+    }
+    return results;
+}
+
+static std::string change(const long long value, const long long baseline) {
+    if (baseline == 0) return "";
+    std::ostringstream os;
+    os << std::showpos << std::fixed << std::setprecision(1) << (value - baseline) * 100.0 / baseline << "%";
+    return os.str();
+}
+
+static void printResults(const std::vector<TResult> &results, const std::map<std::string, TResult> &baseline) {
+    std::cout << std::left << std::setw(20) << "Workload" << std::right
+              << std::setw(8) << "Lines"
+              << std::setw(14) << "Translate ms"
+              << std::setw(10) << "Change"
+              << std::setw(11) << "Minify ms"
+              << std::setw(13) << "Reformat ms"
+              << std::setw(10) << "Write ms"
+              << std::setw(12) << "Lines/s"
+              << std::setw(12) << "Peak RSS KB"
+              << "\n";
+    
+    for (const TResult &result : results) {
+        auto it = baseline.find(result.name);
+        std::cout << std::left << std::setw(20) << result.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(8) << result.lines
+                  << std::setw(14) << result.translate / 1e6
+                  << std::setw(10) << (it != baseline.end() ? change(result.translate, it->second.translate) : "")
+                  << std::setw(11) << result.minify / 1e6
+                  << std::setw(13) << result.reformat / 1e6
+                  << std::setw(10) << result.write / 1e6
+                  << std::setw(12) << std::setprecision(0) << result.linesPerSecond()
+                  << std::setw(12) << result.rss
+                  << "\n";
+    }
+}
+
+// MARK: - Command Line
+
+static void help(void) {
+    std::cout
+    << "Usage: bench [options] <hpppl+>\n"
+    << "\n"
+    << "Options:\n"
+    << "  --root <dir>            Repository root holding the Examples/ and Apps/ projects.\n"
+    << "  --scratch <dir>         Directory for generated sources and outputs (default: build/bench).\n"
+    << "  --repeat <n>            Runs of each workload, keeping the best time (default: 3).\n"
+    << "  --baseline <file>       Compare against the results stored in <file>.\n"
+    << "  --tolerance <percent>   Slowdown allowed before a workload fails (default: 20).\n"
+    << "  --output <file>         Write the results as JSON to <file>.\n"
+    << "  --sizes <n,...>         Lines of each synthetic source run (default: 1000,5000,10000).\n"
+    << "  --generate <dir>        Only generate a synthetic source, using the shape below.\n"
+    << "\n"
+    << "Synthetic Source Shape:\n"
+    << "  --lines <n>             Lines of code in the main file (default: 2000).\n"
+    << "  --aliases <n>           Aliases defined and used (default: 50).\n"
+    << "  --regex <n>             Regex rules defined and used (default: 20).\n"
+    << "  --dictionaries <n>      Dictionaries defined and used (default: 5).\n"
+    << "  --includes <n>          Included PPL+ files (default: 4).\n"
+    << "  --python <n>            #PYTHON blocks (default: 2).\n"
+    << "  --depth <n>             Nesting depth within each function (default: 3).\n"
+    << "\n"
+    << "Without --generate, a synthetic source of each size is generated and run\n"
+    << "along with the projects found under --root.\n";
+}
+
+int main(int argc, const char **argv) {
+    fs::path tool, root, scratch = "build/bench", baseline, output, generateOnly;
+    int repeat = 3;
+    double tolerance = 20;
+    TShape shape;
+    std::vector<long> sizes = {1000, 5000, 10000};
+    
+    for (int n = 1; n < argc; ++n) {
+        std::string args(argv[n]);
+        
+        auto value = [&]() -> std::string {
+            if (++n >= argc) {
+                std::cerr << "❌ error: " << args << " requires a value.\n";
+                exit(1);
+            }
+            return argv[n];
+        };
+        
+        if (args == "--help") { help(); return 0; }
+        if (args == "--root") { root = value(); continue; }
+        if (args == "--scratch") { scratch = value(); continue; }
+        if (args == "--repeat") { repeat = std::max(1, std::atoi(value().c_str())); continue; }
+        if (args == "--baseline") { baseline = value(); continue; }
+        if (args == "--tolerance") { tolerance = std::atof(value().c_str()); continue; }
+        if (args == "--output") { output = value(); continue; }
+        if (args == "--generate") { generateOnly = value(); continue; }
+        if (args == "--sizes") {
+            std::istringstream is(value());
+            std::string size;
+            sizes.clear();
+            while (getline(is, size, ',')) sizes.push_back(std::atol(size.c_str()));
+            continue;
+        }
+        if (args == "--lines") { shape.lines = std::atol(value().c_str()); continue; }
+        if (args == "--aliases") { shape.aliases = std::atol(value().c_str()); continue; }
+        if (args == "--regex") { shape.regexps = std::atol(value().c_str()); continue; }
+        if (args == "--dictionaries") { shape.dictionaries = std::atol(value().c_str()); continue; }
+        if (args == "--includes") { shape.includes = std::atol(value().c_str()); continue; }
+        if (args == "--python") { shape.python = std::atol(value().c_str()); continue; }
+        if (args == "--depth") { shape.depth = std::atol(value().c_str()); continue; }
+        if (args.starts_with("-")) {
+            std::cerr << "❌ error: unknown option " << args << ".\n";
+            return 1;
+        }
+        tool = args;
+    }
+    
+    if (!generateOnly.empty()) {
+        generate(generateOnly, shape);
+        return 0;
+    }
+    
+    if (tool.empty() || !fs::exists(tool)) {
+        help();
+        return 1;
+    }
+    tool = fs::absolute(tool);
+    fs::create_directories(scratch);
+    
+    std::vector<TWorkload> workloads;
+    for (const long lines : sizes) {
+        TShape sized = shape;
+        sized.lines = lines;
+        std::string name = "synthetic-" + std::to_string(lines);
+        generate(scratch / name, sized);
+        workloads.push_back({name, fs::absolute(scratch / name / "main.hppplplus"), countLines(scratch / name)});
+    }
+    
+    if (!root.empty()) {
+        for (const std::string group : {"Examples", "Apps"}) {
+            if (!fs::is_directory(root / group)) continue;
+            std::vector<fs::path> projects;
+            for (const auto &entry : fs::directory_iterator(root / group)) {
+                if (fs::exists(entry.path() / "main.hppplplus")) projects.push_back(entry.path());
+            }
+            std::sort(projects.begin(), projects.end());
+            for (const auto &project : projects) {
+                workloads.push_back({group + "/" + project.filename().string(), fs::absolute(project / "main.hppplplus"), countLines(project)});
+            }
+        }
+    }
+    
+    std::vector<TResult> results;
+    for (const auto &workload : workloads) {
+        TResult result;
+        if (!measure(tool, workload, scratch, repeat, result)) return 1;
+        results.push_back(result);
+    }
+    
+    std::map<std::string, TResult> previous;
+    if (!baseline.empty()) {
+        if (fs::exists(baseline)) {
+            previous = readResults(baseline);
+        } else {
+            std::cerr << "⚠️ warning: no baseline at " << baseline.string() << ", comparison skipped. Record one first with `make bench-baseline`.\n";
+        }
+    }
+    
+    printResults(results, previous);
+    
+    if (!output.empty()) {
+        std::ofstream os(output);
+        writeResults(os, results);
+    }
+    
+    bool regressed = false;
+    for (const TResult &result : results) {
+        auto it = previous.find(result.name);
+        if (it == previous.end() || it->second.translate == 0) continue;
+        if (result.translate > it->second.translate * (1 + tolerance / 100)) {
+            std::cerr << "❌ " << result.name << " is " << change(result.translate, it->second.translate) << " slower than the baseline.\n";
+            regressed = true;
+        }
+    }
+    
+    return regressed ? 1 : 0;
+}
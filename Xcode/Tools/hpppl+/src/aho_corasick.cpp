@@ -0,0 +1,124 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "aho_corasick.hpp"
+
+#include <deque>
+#include <algorithm>
+
+using hppplplus::AhoCorasick;
+
+size_t AhoCorasick::insert(std::string_view key) {
+    _keys.emplace_back(key);
+    _dirty = true;
+    return _keys.size() - 1;
+}
+
+void AhoCorasick::clear(void) {
+    _keys.clear();
+    _nodes.clear();
+    _dirty = true;
+}
+
+int AhoCorasick::child(const int node, const unsigned char c) const {
+    const auto &next = _nodes[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c, [](const std::pair<unsigned char, int> &edge, const unsigned char c) {
+        return edge.first < c;
+    });
+    if (it == next.end() || it->first != c) return -1;
+    return it->second;
+}
+
+void AhoCorasick::build(void) {
+    _nodes.clear();
+    _nodes.emplace_back();
+    
+    // Build the trie of all the keys.
+    for (size_t id = 0; id < _keys.size(); ++id) {
+        int node = 0;
+        for (const unsigned char c : _keys[id]) {
+            int next = child(node, c);
+            if (next < 0) {
+                next = static_cast<int>(_nodes.size());
+                _nodes.emplace_back();
+                auto &edges = _nodes[node].next;
+                auto it = std::lower_bound(edges.begin(), edges.end(), c, [](const std::pair<unsigned char, int> &edge, const unsigned char c) {
+                    return edge.first < c;
+                });
+                edges.insert(it, {c, next});
+            }
+            node = next;
+        }
+        _nodes[node].output.push_back(id);
+    }
+    
+    // Breadth-first, link each node to the longest proper suffix of its path that is
+    // also a path in the trie, and inherit the keys that end at that suffix.
+    std::deque<int> queue;
+    for (const auto &edge : _nodes[0].next) {
+        _nodes[edge.second].fail = 0;
+        queue.push_back(edge.second);
+    }
+    
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop_front();
+        
+        for (const auto &edge : _nodes[node].next) {
+            int fail = _nodes[node].fail;
+            int next = child(fail, edge.first);
+            while (next < 0 && fail != 0) {
+                fail = _nodes[fail].fail;
+                next = child(fail, edge.first);
+            }
+            _nodes[edge.second].fail = next < 0 || next == edge.second ? 0 : next;
+            
+            const auto &inherited = _nodes[_nodes[edge.second].fail].output;
+            _nodes[edge.second].output.insert(_nodes[edge.second].output.end(), inherited.begin(), inherited.end());
+            
+            queue.push_back(edge.second);
+        }
+    }
+    
+    _dirty = false;
+}
+
+void AhoCorasick::scan(std::string_view text, const std::function<void(size_t position, size_t id)> &found) {
+    if (_keys.empty()) return;
+    if (_dirty) build();
+    
+    int node = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = text[i];
+        
+        int next = child(node, c);
+        while (next < 0 && node != 0) {
+            node = _nodes[node].fail;
+            next = child(node, c);
+        }
+        node = next < 0 ? 0 : next;
+        
+        for (const size_t id : _nodes[node].output) {
+            found(i + 1 - _keys[id].size(), id);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace hppplplus {
+    /*
+     A multi-pattern string matcher that finds every occurrence of every key in a
+     single left-to-right pass over the text, regardless of how many keys there are.
+     
+     Keys are added with `insert`, which returns the id reported back for that key
+     when it is found. The automaton is (re)built on demand the first time `scan`
+     is called after the set of keys has changed.
+     */
+    class AhoCorasick {
+    public:
+        size_t insert(std::string_view key);
+        void clear(void);
+        
+        bool empty(void) const {
+            return _keys.empty();
+        }
+        
+        size_t size(void) const {
+            return _keys.size();
+        }
+        
+        const std::string &key(const size_t id) const {
+            return _keys[id];
+        }
+        
+        /*
+         Calls `found` for every occurrence of every key within the text, passing the
+         position of the first character of the occurrence and the id of the key.
+         Occurrences are reported in order of the position they end at.
+         */
+        void scan(std::string_view text, const std::function<void(size_t position, size_t id)> &found);
+        
+    private:
+        typedef struct TNode {
+            std::vector<std::pair<unsigned char, int>> next;
+            int fail = 0;
+            std::vector<size_t> output;     // ids of the keys ending at this node
+        } TNode;
+        
+        std::vector<std::string> _keys;
+        std::vector<TNode> _nodes;
+        bool _dirty = true;
+        
+        void build(void);
+        int child(const int node, const unsigned char c) const;
+    };
+}
@@ -21,28 +21,31 @@
 // SOFTWARE.
 
 #include "alias.hpp"
+#include "strings.hpp"
+#include "patterns.hpp"
 
 #include <sstream>
 #include <regex>
 
 using hppplplus::Alias;
+using hppplplus::Patterns;
 
 
-std::string Alias::parse(const std::string &str) {
+std::string Alias::parse(const std::string &str, TranslationContext &context) {
     std::string s;
-    std::regex re;
     std::smatch matches;
     std::string output = str;
     
-    re = std::regex(R"(\balias\b *(@)?([a-z_]\w*(?:::[a-z]\w*)*) *:= *([^\r\n\t\f\v ]+) *;)", std::regex_constants::icase);
-    while (regex_search(output, matches, re)) {
+    if (!containsIgnoringCase(output, "alias")) return output;
+    
+    while (regex_search(output, matches, Patterns::shared().alias)) {
         Aliases::TIdentity identity;
         identity.identifier = matches.str(2);
         identity.real = matches.str(3);
         identity.type = Aliases::Type::Alias;
-        identity.scope = matches[1].matched ? 0 : Singleton::shared()->scopeDepth;
+        identity.scope = matches[1].matched ? 0 : context.scopeDepth;
         
-        Singleton::shared()->aliases.append(identity);
+        context.aliases.append(identity);
         output.replace(matches.position(), matches.length(), "");
     }
     
@@ -23,11 +23,11 @@
 #pragma once
 
 #include "aliases.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 
 namespace hppplplus {
     class Alias {
     public:
-        static std::string parse(const std::string &str);
+        static std::string parse(const std::string &str, TranslationContext &context);
     };
 }
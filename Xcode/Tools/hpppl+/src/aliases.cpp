@@ -23,7 +23,8 @@
 #include "aliases.hpp"
 #include "common.hpp"
 
-#include "singleton.hpp"
+#include "translation_context.hpp"
+#include "strings.hpp"
 #include <regex>
 #include <sstream>
 #include <algorithm>
@@ -32,135 +33,29 @@ using hppplplus::Aliases;
 
 //MARK: - Functions
 
-static bool compareInterval(Aliases::TIdentity i1, Aliases::TIdentity i2) {
-    return (i1.identifier.length() > i2.identifier.length());
+static bool isRegularExpression(const Aliases::TIdentity &identity) {
+    return '`' == identity.identifier.at(0) && '`' == identity.identifier.at(identity.identifier.length() - 1);
+}
+
+static size_t scopeLevel(const Aliases::TIdentity &identity) {
+    return identity.scope < 0 ? 0 : static_cast<size_t>(identity.scope);
 }
 
 //static bool compareIntervalString(std::string i1, std::string i2) {
 //    return (i1.length() > i2.length());
 //}
 
-/**
- * @brief Extracts and preserves all double-quoted substrings from the input string.
- *
- * Handles escaped quotes (e.g., \" inside quoted text) and does not use regex.
- *
- * @param str The input string.
- * @return std::list<std::string> A list of quoted substrings, including the quote characters.
- */
-static std::list<std::string> preserveStrings(const std::string& str) {
-    std::list<std::string> strings;
-    bool inQuotes = false;
-    std::string current;
-    
-    for (size_t i = 0; i < str.size(); ++i) {
-        char c = str[i];
-
-        if (!inQuotes) {
-            if (c == '"') {
-                inQuotes = true;
-                current.clear();
-                current += c;  // start quote
-            }
-        } else {
-            current += c;
-
-            if (c == '"' && (i == 0 || str[i - 1] != '\\')) {
-                // End of quoted string (unescaped quote)
-                inQuotes = false;
-                strings.push_back(current);
-            }
-        }
-    }
-
-    return strings;
-}
-/**
- * @brief Replaces all double-quoted substrings in the input string with "".
- *
- * Handles escaped quotes (e.g., \" inside strings) and does not use regex.
- *
- * @param str The input string to process.
- * @return std::string A new string with quoted substrings replaced by "".
- */
-static std::string blankOutStrings(const std::string& str) {
-    std::string result;
-    bool inQuotes = false;
-    size_t start = 0;
-
-    for (size_t i = 0; i < str.length(); ++i) {
-        // Start of quoted string
-        if (!inQuotes && str[i] == '"') {
-            inQuotes = true;
-            result.append(str, start, i - start);  // Append text before quote
-            start = i; // mark quote start
-        }
-        // Inside quoted string
-        else if (inQuotes && str[i] == '"' && (i == 0 || str[i - 1] != '\\')) {
-            // End of quoted string
-            inQuotes = false;
-            result += "\"\"";  // Replace quoted string with empty quotes
-            start = i + 1;     // Next copy chunk starts after closing quote
-        }
-    }
-
-    // Append remaining text after last quoted section
-    if (start < str.size()) {
-        result.append(str, start, str.size() - start);
-    }
-
-    return result;
-}
-
-/**
- * @brief Restores quoted strings into a string that had them blanked out.
- *
- * @param str The string with blanked-out quoted substrings (e.g., `""`).
- * @param strings A list of original quoted substrings, in the order they appeared.
- * @return std::string A new string with the original quoted substrings restored.
- */
-static std::string restoreStrings(const std::string& str, std::list<std::string>& strings) {
-    static const std::regex re(R"("[^"]*")");
-
-    if (strings.empty()) return str;
-
-    std::string result;
-    std::size_t lastPos = 0;
-
-    auto stringIt = strings.begin();
-    for (auto it = std::sregex_iterator(str.begin(), str.end(), re);
-         it != std::sregex_iterator() && stringIt != strings.end(); ++it, ++stringIt)
-    {
-        const std::smatch& match = *it;
-
-        // Append the part before the match
-        result.append(str, lastPos, match.position() - lastPos);
-
-        // Append the preserved quoted string
-        result.append(*stringIt);
-
-        // Update the last position
-        lastPos = match.position() + match.length();
-    }
-
-    // Append the remaining part of the string after the last match
-    result.append(str, lastPos, std::string::npos);
-
-    return result;
-}
-
 //MARK: - Public Methods
 
 bool Aliases::append(const TIdentity &idty) {
     TIdentity identity = idty;
-    Singleton *singleton = Singleton::shared();
     
     if (identity.identifier.empty()) return false;
     
     trim(identity.identifier);
     trim(identity.real);
-    identity.path = singleton->currentSourceFilePath();
-    identity.line = singleton->currentLineNumber();
+    identity.path = _context.currentSourceFilePath();
+    identity.line = _context.currentLineNumber();
     
     if (!identity.message.empty()) {
         trim(identity.message);
@@ -168,38 +63,43 @@ bool Aliases::append(const TIdentity &idty) {
     }
     
     if (identity.scope == -1) {
-        identity.scope = Singleton::shared()->scopeDepth;
+        identity.scope = _context.scopeDepth;
     }
     
     if (identity.type == Type::Argument) identity.scope = 1;
     
-    std::string filename = Singleton::shared()->currentSourceFilePath().filename().string();
+    std::string filename = _context.currentSourceFilePath().filename().string();
     
     
-    if (identifierExists(identity.identifier)) {
-        for (const auto &it : _identities) {
-            if (it.identifier == identity.identifier) {
-                std::cerr
-                << MessageType::Warning
-                << "redefinition of: " << identity.identifier << ", ";
-                if (filename == it.path.filename()) {
-                    std::cerr << "previous definition on line " << it.line << "\n";
-                }
-                else {
-                    std::cerr << "previous definition in " << it.path.filename() << " on line " << it.line << "\n";
-                }
-                break;
-            }
+    auto existing = _index.find(identity.identifier);
+    if (existing != _index.end()) {
+        const TIdentity &it = *existing->second;
+        diagnostics()
+        << MessageType::Warning
+        << "redefinition of: " << identity.identifier << ", ";
+        if (filename == it.path.filename()) {
+            diagnostics() << "previous definition on line " << it.line << "\n";
+        }
+        else {
+            diagnostics() << "previous definition in " << it.path.filename() << " on line " << it.line << "\n";
         }
         return false;
     }
     
-    _identities.push_back(identity);
+    size_t level = scopeLevel(identity);
+    if (_frames.size() <= level) _frames.resize(level + 1);
+    auto it = _frames[level].insert(_frames[level].end(), identity);
+    _index.emplace(identity.identifier, it);
     
-    // Resort in descending order
-    std::sort(_identities.begin(), _identities.end(), compareInterval);
+    if (isRegularExpression(identity)) {
+        // Kept in descending order of length as they are inserted.
+        _fallbacks.emplace(identity.identifier.length(), it);
+        _dirty = true;
+    } else {
+        _symbols.insert(identity.identifier, identity.real);
+    }
     
-    if (verbose) std::cerr
+    if (verbose) diagnostics()
         << MessageType::Verbose
         << "defined "
         << (identity.scope > 0 ? "local " : "")
@@ -215,9 +115,11 @@ bool Aliases::append(const TIdentity &idty) {
 }
 
 void Aliases::removeAllOutOfScopeAliases() {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->scope > Singleton::shared()->scopeDepth) {
-            if (verbose) std::cerr
+    const size_t scopeDepth = static_cast<size_t>(_context.scopeDepth);
+    
+    while (_frames.size() > scopeDepth + 1) {
+        for (auto it = _frames.back().begin(); it != _frames.back().end(); ++it) {
+            if (verbose) diagnostics()
                 << MessageType::Verbose
                 << "removed " << "local" << " "
                 << (Type::Unknown == it->type ? "alias " : "")
@@ -227,17 +129,20 @@ void Aliases::removeAllOutOfScopeAliases() {
                 << (Type::Argument == it->type ? "argument alias " : "")
                 << (Type::Variable == it->type ? "variable alias " : "")
                 << "'" << it->identifier << "'\n";
-            _identities.erase(it);
-            removeAllOutOfScopeAliases();
-            break;
+            forget(it);
         }
+        _frames.pop_back();
     }
 }
 
 void Aliases::removeAllAliasesOfType(const Type type) {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->type == type) {
-            if (verbose) std::cerr
+    for (auto &frame : _frames) {
+        for (auto it = frame.begin(); it != frame.end(); ) {
+            if (it->type != type) {
+                ++it;
+                continue;
+            }
+            if (verbose) diagnostics()
                 << MessageType::Verbose
                 << "removed " << "local" << " "
                 << (Type::Unknown == it->type ? "alias " : "")
@@ -247,9 +152,7 @@ void Aliases::removeAllAliasesOfType(const Type type) {
                 << (Type::Argument == it->type ? "argument alias " : "")
                 << (Type::Variable == it->type ? "variable alias " : "")
                 << "'" << it->identifier << "'\n";
-            _identities.erase(it);
-            removeAllAliasesOfType(type);
-            break;
+            erase(it++);
         }
     }
 }
@@ -257,25 +160,31 @@ void Aliases::removeAllAliasesOfType(const Type type) {
 std::string Aliases::resolveAllAliasesInText(const std::string &str) {
     std::string s = str;
     std::regex re;
-    std::smatch match;
-    std::string namespaces, pattern;
     
     if (s.empty()) return s;
     
     auto strings = preserveStrings(s);
     s = blankOutStrings(s);
     
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if ('`' == it->identifier.at(0) && '`' == it->identifier.at(it->identifier.length() - 1)) {
-            pattern = it->identifier;
-        } else {
-            pattern = R"(\b)" + it->identifier + R"(\b)";
-        }
-        
-        re = pattern;
+    _symbols.replaceAll(s);
+    
+    if (_dirty) reindex();
+    
+    if (!_fallbacks.empty()) {
+        // Only identities whose required literal occurs within the text can possibly match.
+        auto candidates = _prefilter.candidates(s);
         
-        if (!regex_search(s, re)) continue;
-        s = regex_replace(s, re, it->real);
+        size_t i = 0;
+        for (auto it = _fallbacks.begin(); it != _fallbacks.end(); ++it, ++i) {
+            if (!candidates[i]) continue;
+            
+            const TIdentity &identity = *it->second;
+            re = identity.identifier;
+            
+            if (!regex_search(s, re)) continue;
+            s = regex_replace(s, re, identity.real);
+            candidates = _prefilter.candidates(s);
+        }
     }
     s = restoreStrings(s, strings);
     
@@ -287,67 +196,193 @@ std::string Aliases::resolveAllAliasesInText(const std::string &str) {
     return s;
 }
 
+void Aliases::reindex(void) {
+    _prefilter.clear();
+    
+    size_t i = 0;
+    for (const auto &fallback : _fallbacks) {
+        _prefilter.insert(i++, fallback.second->identifier);
+    }
+    _dirty = false;
+}
 
-
-void Aliases::remove(const std::string &identifier) {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->identifier == identifier) {
-            if (verbose) std::cerr
-                << MessageType::Verbose
-                << "removed "
-                << (it->scope > 0 ? "local " : "")
-                << (Type::Unknown == it->type ? "alias " : "")
-                << (Type::CompileTimeSymbol == it->type ? "compile-time symbol " : "")
-                << (Type::Alias == it->type ? "alias " : "")
-                << (Type::Function == it->type ? "function alias " : "")
-                << (Type::Argument == it->type ? "argument alias " : "")
-                << (Type::Variable == it->type ? "variable alias " : "")
-                << "'" << it->identifier << "'\n";
-            
-            _identities.erase(it);
+// Drops every reference to the identity, leaving it within its frame.
+void Aliases::forget(const TFrame::iterator &it) {
+    _index.erase(it->identifier);
+    
+    if (!isRegularExpression(*it)) {
+        _symbols.remove(it->identifier);
+        return;
+    }
+    
+    auto range = _fallbacks.equal_range(it->identifier.length());
+    for (auto fallback = range.first; fallback != range.second; ++fallback) {
+        if (fallback->second == it) {
+            _fallbacks.erase(fallback);
             break;
         }
     }
+    _dirty = true;
+}
+
+void Aliases::erase(const TFrame::iterator &it) {
+    size_t level = scopeLevel(*it);
+    forget(it);
+    _frames[level].erase(it);
+}
+
+
+
+void Aliases::remove(const std::string &identifier) {
+    auto existing = _index.find(identifier);
+    if (existing == _index.end()) return;
+    
+    auto it = existing->second;
+    if (verbose) diagnostics()
+        << MessageType::Verbose
+        << "removed "
+        << (it->scope > 0 ? "local " : "")
+        << (Type::Unknown == it->type ? "alias " : "")
+        << (Type::CompileTimeSymbol == it->type ? "compile-time symbol " : "")
+        << (Type::Alias == it->type ? "alias " : "")
+        << (Type::Function == it->type ? "function alias " : "")
+        << (Type::Argument == it->type ? "argument alias " : "")
+        << (Type::Variable == it->type ? "variable alias " : "")
+        << "'" << it->identifier << "'\n";
+    
+    erase(it);
 }
 
 
 
 bool Aliases::identifierExists(const std::string &identifier) {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->identifier == identifier) {
-            return true;
+    return _index.contains(identifier);
+}
+
+bool Aliases::realExists(const std::string &real) {
+    for (const auto &frame : _frames) {
+        for (const auto &identity : frame) {
+            if (identity.real == real) {
+                return true;
+            }
         }
     }
     
     return false;
 }
 
-bool Aliases::realExists(const std::string &real) {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->real == real) {
-            return true;
+void Aliases::dumpIdentities() {
+    for (const auto &frame : _frames) {
+        for (const auto &identity : frame) {
+            if (verbose) diagnostics() << "_identities : " << identity.identifier << " = " << identity.real << "\n";
         }
     }
+}
+
+void Aliases::save(ArchiveWriter &archive, const bool locations) const {
+    std::unordered_map<const TIdentity *, std::pair<size_t, size_t>> positions;
     
-    return false;
+    archive.write(_frames.size());
+    for (size_t level = 0; level < _frames.size(); ++level) {
+        archive.write(_frames[level].size());
+        
+        size_t position = 0;
+        for (const auto &identity : _frames[level]) {
+            positions[&identity] = {level, position++};
+            archive.write(identity.identifier);
+            archive.write(identity.real);
+            archive.write(static_cast<long long>(identity.type));
+            archive.write(identity.scope);
+            archive.write(identity.deprecated);
+            archive.write(identity.message);
+            if (!locations) continue;
+            archive.write(identity.line);
+            archive.write(identity.path.string());
+        }
+    }
+    
+    archive.write(_fallbacks.size());
+    for (const auto &fallback : _fallbacks) {
+        auto position = positions.at(&*fallback.second);
+        archive.write(position.first);
+        archive.write(position.second);
+    }
 }
 
-void Aliases::dumpIdentities() {
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (verbose) std::cerr << "_identities : " << it->identifier << " = " << it->real << "\n";
+bool Aliases::load(ArchiveReader &archive) {
+    size_t levels = 0, count = 0;
+    std::deque<TFrame> frames;
+    std::vector<std::vector<TFrame::iterator>> positions;
+    
+    if (!archive.read(levels)) return false;
+    frames.resize(levels);
+    positions.resize(levels);
+    
+    for (size_t level = 0; level < levels; ++level) {
+        if (!archive.read(count)) return false;
+        
+        for (size_t i = 0; i < count; ++i) {
+            TIdentity identity;
+            std::string path;
+            
+            archive.read(identity.identifier);
+            archive.read(identity.real);
+            archive.read(identity.type);
+            archive.read(identity.scope);
+            archive.read(identity.deprecated);
+            archive.read(identity.message);
+            archive.read(identity.line);
+            if (!archive.read(path)) return false;
+            identity.path = path;
+            
+            auto existing = _index.find(identity.identifier);
+            if (existing != _index.end()) {
+                const TIdentity &current = *existing->second;
+                if (current.real == identity.real && current.type == identity.type && current.scope == identity.scope) {
+                    identity.line = current.line;
+                    identity.path = current.path;
+                }
+            }
+            
+            positions[level].push_back(frames[level].insert(frames[level].end(), identity));
+        }
+    }
+    
+    std::vector<TFrame::iterator> fallbacks;
+    if (!archive.read(count)) return false;
+    for (size_t i = 0; i < count; ++i) {
+        size_t level = 0, position = 0;
+        archive.read(level);
+        if (!archive.read(position) || level >= levels || position >= positions[level].size()) return false;
+        fallbacks.push_back(positions[level][position]);
+    }
+    
+    _frames = std::move(frames);
+    _index.clear();
+    _symbols.clear();
+    _fallbacks.clear();
+    
+    for (auto &frame : _frames) {
+        for (auto it = frame.begin(); it != frame.end(); ++it) {
+            _index.emplace(it->identifier, it);
+            if (!isRegularExpression(*it)) _symbols.insert(it->identifier, it->real);
+        }
+    }
+    
+    // Inserted in the order they were archived in, equal lengths keep their order of resolution.
+    for (const auto &it : fallbacks) {
+        _fallbacks.emplace(it->identifier.length(), it);
     }
+    _dirty = true;
+    
+    return true;
 }
 
 const Aliases::TIdentity Aliases::getIdentity(const std::string &identifier) {
     TIdentity identity;
-    for (auto it = _identities.begin(); it != _identities.end(); ++it) {
-        if (it->identifier == identifier) {
-            return *it;
-        }
+    auto existing = _index.find(identifier);
+    if (existing != _index.end()) {
+        return *existing->second;
     }
     return identity;
 }
-
-
-
-
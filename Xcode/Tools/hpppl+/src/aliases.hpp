@@ -24,12 +24,21 @@
 
 #include <iostream>
 #include <list>
+#include <deque>
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include <stdint.h>
 #include <fstream>
 #include <filesystem>
 
+#include "prefilter.hpp"
+#include "symbol_trie.hpp"
+#include "archive.hpp"
+
 namespace hppplplus {
+    class TranslationContext;
+    
     class Aliases {
     public:
         enum class Type {
@@ -56,6 +65,9 @@ namespace hppplplus {
         
         bool verbose = false;
         
+        // Identities are defined at the scope depth and location the context has reached.
+        explicit Aliases(const TranslationContext &context) : _context(context) {}
+        
         bool append(const TIdentity &identity);
         void removeAllOutOfScopeAliases();
         void removeAllAliasesOfType(const Type type);
@@ -68,9 +80,51 @@ namespace hppplplus {
         void dumpIdentities();
         const TIdentity getIdentity(const std::string &identifier);
         
+        /*
+         Saves every identity, frame by frame, along with the order regular expression
+         identities are resolved in. Without `locations` the line and file of each
+         definition are left out, so the archive depends only on what the identities are.
+         */
+        void save(ArchiveWriter &archive, const bool locations) const;
+        
+        /*
+         Replaces every identity with those of an archive saved with locations. An
+         identity that is already defined exactly as archived keeps its own location.
+         */
+        bool load(ArchiveReader &archive);
+        
         
         
     private:
-        std::vector<TIdentity> _identities;
+        typedef std::list<TIdentity> TFrame;
+        
+        const TranslationContext &_context;
+        
+        /*
+         A frame per scope level holding the identities local to that level, so leaving
+         a scope drops its identities without a search. Each identifier is indexed to
+         its entry within its frame.
+         */
+        std::deque<TFrame> _frames;
+        std::unordered_map<std::string, TFrame::iterator> _index;
+        
+        /*
+         All plain identifiers are resolved in one pass through `_symbols`, which is
+         kept up to date as identities are appended and removed.
+         */
+        SymbolTrie _symbols;
+        
+        /*
+         Backtick-delimited identifiers are regular expressions and fall back to being
+         resolved one by one, longest identifier first. A literal prefilter over their
+         patterns, in the same order, is rebuilt lazily whenever they have changed.
+         */
+        std::multimap<size_t, TFrame::iterator, std::greater<size_t>> _fallbacks;
+        Prefilter _prefilter;
+        bool _dirty = false;
+        
+        void reindex(void);
+        void forget(const TFrame::iterator &it);
+        void erase(const TFrame::iterator &it);
     };
 }
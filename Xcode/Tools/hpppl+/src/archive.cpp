@@ -0,0 +1,70 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "archive.hpp"
+
+#include <charconv>
+
+using hppplplus::ArchiveWriter;
+using hppplplus::ArchiveReader;
+
+void ArchiveWriter::write(const long long value) {
+    _data.append(std::to_string(value));
+    _data.push_back(';');
+}
+
+void ArchiveWriter::write(std::string_view value) {
+    _data.append(std::to_string(value.length()));
+    _data.push_back(':');
+    _data.append(value);
+}
+
+static bool readNumber(std::string_view &data, const char terminator, long long &value) {
+    size_t end = data.find(terminator);
+    if (end == std::string_view::npos) return false;
+    
+    auto result = std::from_chars(data.data(), data.data() + end, value);
+    if (result.ec != std::errc() || result.ptr != data.data() + end) return false;
+    
+    data.remove_prefix(end + 1);
+    return true;
+}
+
+bool ArchiveReader::read(long long &value) {
+    if (_failed) return false;
+    _failed = !readNumber(_data, ';', value);
+    return !_failed;
+}
+
+bool ArchiveReader::read(std::string &value) {
+    long long length;
+    
+    if (_failed) return false;
+    if (!readNumber(_data, ':', length) || length < 0 || static_cast<size_t>(length) > _data.length()) {
+        _failed = true;
+        return false;
+    }
+    
+    value.assign(_data.substr(0, static_cast<size_t>(length)));
+    _data.remove_prefix(static_cast<size_t>(length));
+    return true;
+}
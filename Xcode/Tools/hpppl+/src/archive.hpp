@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace hppplplus {
+    /*
+     A minimal encoding for persisting translation state.
+     
+     Numbers are written as decimal text ending in `;` and strings are prefixed with
+     their length, so any content, including newlines and binary, round-trips unchanged.
+     */
+    class ArchiveWriter {
+    public:
+        void write(const long long value);
+        void write(std::string_view value);
+        
+        const std::string &data(void) const {
+            return _data;
+        }
+        
+    private:
+        std::string _data;
+    };
+    
+    class ArchiveReader {
+    public:
+        ArchiveReader(std::string_view data) : _data(data) {}
+        
+        // Each read returns false, leaving the reader failed, when the data is not as expected.
+        bool read(long long &value);
+        bool read(std::string &value);
+        
+        template <typename T>
+        bool read(T &value) {
+            long long n;
+            if (!read(n)) return false;
+            value = static_cast<T>(n);
+            return true;
+        }
+        
+        bool failed(void) const {
+            return _failed;
+        }
+        
+        bool atEnd(void) const {
+            return _data.empty();
+        }
+        
+    private:
+        std::string_view _data;
+        bool _failed = false;
+    };
+}
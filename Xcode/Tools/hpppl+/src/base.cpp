@@ -21,17 +21,20 @@
 // SOFTWARE.
 
 #include "base.hpp"
+#include "patterns.hpp"
 
 #include <regex>
 
 using hppplplus::Base;
+using hppplplus::Patterns;
 
 std::string Base::parse(const std::string &str) {
     std::smatch matches;
     std::string output = str;
-    std::regex re(R"(#(-)?(\d+)([bodh])\((0x[[:xdigit:]]+|[[:xdigit:]]+(?:\.[[:xdigit:]]+)?|0[0-7]+|0b[0-1]+)\))");
     
-    if (regex_search(output, matches, re)) {
+    if (output.find('#') == std::string::npos) return output;
+    
+    if (regex_search(output, matches, Patterns::shared().base)) {
         std::string s;
         s = "#" + matches.str(4) + ":" + matches.str(1) + matches.str(2) + matches.str(3);
         output.replace(matches.position(), matches.length(), s);
@@ -0,0 +1,151 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "build_record.hpp"
+#include "translation_cache.hpp"
+#include "archive.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include "../version_code.h"
+
+using hppplplus::BuildRecord;
+using hppplplus::TranslationCache;
+using hppplplus::ArchiveWriter;
+using hppplplus::ArchiveReader;
+
+namespace fs = std::filesystem;
+
+static const char *signature = "hpppl+ build record";
+
+BuildRecord::BuildRecord(const fs::path &path) {
+    _directory = fs::absolute(path).lexically_normal().parent_path();
+    _path = _directory / ("." + path.stem().string() + ".xprimebuild");
+    
+    std::ifstream infile(_path, std::ios::in | std::ios::binary);
+    if (!infile.is_open()) return;
+    
+    std::ostringstream contents;
+    contents << infile.rdbuf();
+    
+    const std::string data = contents.str();
+    ArchiveReader archive(data);
+    std::string str;
+    long long build = 0;
+    size_t count = 0;
+    
+    // A record left by any other build of hpppl+ is disregarded, as it may translate differently.
+    if (!archive.read(str) || str != signature) return;
+    if (!archive.read(build) || build != NUMERIC_BUILD) return;
+    
+    archive.read(count);
+    for (size_t i = 0; i < count && !archive.failed(); ++i) {
+        std::string output, dependency;
+        TOutput entry;
+        size_t dependencies = 0;
+        
+        archive.read(output);
+        archive.read(entry.settings);
+        archive.read(entry.digest);
+        archive.read(dependencies);
+        for (size_t j = 0; j < dependencies && !archive.failed(); ++j) {
+            std::string digest;
+            archive.read(dependency);
+            archive.read(digest);
+            entry.dependencies.emplace(dependency, digest);
+        }
+        
+        if (!archive.failed()) _outputs.emplace(output, entry);
+    }
+}
+
+fs::path BuildRecord::relative(const fs::path &path) const {
+    return fs::absolute(path).lexically_normal().lexically_proximate(_directory);
+}
+
+bool BuildRecord::upToDate(const fs::path &output, const std::string &settings) const {
+    auto it = _outputs.find(relative(output));
+    if (it == _outputs.end()) return false;
+    
+    const TOutput &entry = it->second;
+    if (entry.settings != settings) return false;
+    if (TranslationCache::fileDigest(output) != entry.digest) return false;
+    
+    for (const auto &dependency : entry.dependencies) {
+        if (TranslationCache::fileDigest(_directory / dependency.first) != dependency.second) return false;
+    }
+    return true;
+}
+
+void BuildRecord::record(const fs::path &output, const std::string &settings, const std::map<fs::path, std::string> &dependencies) {
+    TOutput entry;
+    
+    entry.settings = settings;
+    entry.digest = TranslationCache::fileDigest(output);
+    for (const auto &dependency : dependencies) {
+        entry.dependencies.emplace(relative(dependency.first), dependency.second);
+    }
+    
+    _outputs[relative(output)] = entry;
+}
+
+void BuildRecord::forget(const fs::path &output) {
+    _outputs.erase(relative(output));
+}
+
+std::map<fs::path, std::string> BuildRecord::dependencies(const fs::path &output) const {
+    std::map<fs::path, std::string> dependencies;
+    
+    auto it = _outputs.find(relative(output));
+    if (it == _outputs.end()) return dependencies;
+    
+    for (const auto &dependency : it->second.dependencies) {
+        dependencies.emplace((_directory / dependency.first).lexically_normal(), dependency.second);
+    }
+    return dependencies;
+}
+
+bool BuildRecord::save(void) const {
+    ArchiveWriter archive;
+    
+    archive.write(signature);
+    archive.write(NUMERIC_BUILD);
+    archive.write(_outputs.size());
+    for (const auto &output : _outputs) {
+        archive.write(output.first.generic_string());
+        archive.write(output.second.settings);
+        archive.write(output.second.digest);
+        archive.write(output.second.dependencies.size());
+        for (const auto &dependency : output.second.dependencies) {
+            archive.write(dependency.first.generic_string());
+            archive.write(dependency.second);
+        }
+    }
+    
+    std::ofstream outfile(_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open()) return false;
+    outfile.write(archive.data().data(), static_cast<std::streamsize>(archive.data().size()));
+    outfile.close();
+    
+    return !outfile.fail();
+}
@@ -0,0 +1,68 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <filesystem>
+
+namespace hppplplus {
+    /*
+     The record of the last build of a project, kept beside it in a hidden .xprimebuild
+     file. For each output it holds the digest of the settings the output was built with,
+     of every file read building it, and of the output itself, so an output is only built
+     again once one of them differs or the output is gone.
+     
+     Paths are kept relative to the project directory, so the record still holds for
+     the project checked out elsewhere.
+     */
+    class BuildRecord {
+    public:
+        typedef struct TOutput {
+            std::string settings;   // the digest of the settings the output was built with
+            std::string digest;     // the digest of the output as built
+            std::map<std::filesystem::path, std::string> dependencies;
+        } TOutput;
+        
+        // Reads the record of the project at `path`, or starts an empty one.
+        explicit BuildRecord(const std::filesystem::path &path);
+        
+        bool upToDate(const std::filesystem::path &output, const std::string &settings) const;
+        void record(const std::filesystem::path &output, const std::string &settings, const std::map<std::filesystem::path, std::string> &dependencies);
+        void forget(const std::filesystem::path &output);
+        
+        // The files `output` was last built from, with their digests, or none should it never have been.
+        std::map<std::filesystem::path, std::string> dependencies(const std::filesystem::path &output) const;
+        
+        bool save(void) const;
+        
+    private:
+        std::filesystem::path _path;
+        std::filesystem::path _directory;
+        
+        // Keyed by the output, relative to the project directory.
+        std::map<std::filesystem::path, TOutput> _outputs;
+        
+        std::filesystem::path relative(const std::filesystem::path &path) const;
+    };
+}
@@ -22,6 +22,7 @@
 
 #include "calc.hpp"
 #include "common.hpp"
+#include "patterns.hpp"
 
 #include <regex>
 #include <vector>
@@ -31,6 +32,7 @@
 #include <cmath>
 
 using hppplplus::Calc;
+using hppplplus::Patterns;
 
 
 static bool _verbose = false;
@@ -41,10 +43,7 @@ static bool isOperator(char c) {
 }
 
 static bool isExpresionValid(const std::string& expression) {
-    std::regex re;
-    
-    re = R"([\d+\-*\/ πe%&|()]+)";
-    return regex_match(expression, re);
+    return regex_match(expression, Patterns::shared().expression);
 }
 
 // Function to get the precedence of an operator
@@ -63,7 +62,7 @@ static double applyOperator(const double a, const double b, const char op) {
         case '*': return a * b;
         case '/':
             if (b == 0) {
-                std::cerr << MessageType::Error << "#[]: division by zero\n";
+                diagnostics() << MessageType::Error << "#[]: division by zero\n";
                 return 0;
             }
             return a / b;
@@ -71,7 +70,7 @@ static double applyOperator(const double a, const double b, const char op) {
         case '^': return pow(a, b);
             
         default:
-            std::cerr << MessageType::Error << "#[]: unknown '" << op << "' operator\n";
+            diagnostics() << MessageType::Error << "#[]: unknown '" << op << "' operator\n";
             return 0;
     }
 }
@@ -98,7 +97,7 @@ static std::vector<std::string> infixToPostfix(const std::string& expression) {
     std::vector<std::string> output;
     std::stack<char> operators;
     
-    std::regex re(R"([^ ]+)");
+    const std::regex &re = Patterns::shared().term;
     for(auto it = std::sregex_iterator(expression.begin(), expression.end(), re); it != std::sregex_iterator(); ++it ) {
         std::string result = it->str();
         
@@ -127,7 +126,7 @@ static std::vector<std::string> infixToPostfix(const std::string& expression) {
                 operators.pop();
             }
             if (operators.empty()) {
-                std::cerr << MessageType::Error << "#[]: missing '(' in expression '" << expression << "'\n";
+                diagnostics() << MessageType::Error << "#[]: missing '(' in expression '" << expression << "'\n";
                 continue;
             }
                 
@@ -135,7 +134,7 @@ static std::vector<std::string> infixToPostfix(const std::string& expression) {
             continue;
         }
         
-        std::cerr << MessageType::Error << "#[]: uknown '" << result << "' in expression '" << expression << "'\n";
+        diagnostics() << MessageType::Error << "#[]: uknown '" << result << "' in expression '" << expression << "'\n";
     }
 
     while (!operators.empty()) {
@@ -144,14 +143,14 @@ static std::vector<std::string> infixToPostfix(const std::string& expression) {
     }
     
     if (_verbose) {
-        std::cerr << MessageType::Verbose << "calc: RPN: ";
+        diagnostics() << MessageType::Verbose << "calc: RPN: ";
         for (auto it = output.begin(); it != output.end(); ) {
-            std::cerr << *it;
+            diagnostics() << *it;
             if (++it != output.end()) {
-                std::cerr << ",";
+                diagnostics() << ",";
             }
         }
-        std::cerr << "\n";
+        diagnostics() << "\n";
     }
 
     return output;
@@ -246,11 +245,9 @@ static std::string decimalUnsignedNumber(int64_t num, int bitWidth) {
 
 // Function to convert a string with PPL-style integer number to return a base 10 number
 static std::string convertPPLIntegerNumberToBase10(const std::string& str) {
-    std::regex re;
     std::smatch match;
     
-    re = R"(#([\dA-F]+)(?::(-)?(6[0-4]|[1-5][0-9]|[1-9]))?([odh])?)";
-    if (!regex_search(str, match, re)) return str;
+    if (!regex_search(str, match, Patterns::shared().integer)) return str;
     
     /*
      Group 1 The hex part of the string.
@@ -274,12 +271,10 @@ static std::string convertPPLIntegerNumberToBase10(const std::string& str) {
 
 // Function to convert a string with PPL-style integer number to a plain base 10 number
 static void convertPPLStyleNumbersToBase10(std::string& str) {
-    std::regex re;
     std::smatch match;
     std::string s;
     
-    re = R"(#([\dA-F])+(?::-?\d+)?([odh])?)";
-    while (regex_search(str, match, re)) {
+    while (regex_search(str, match, Patterns::shared().integerNumber)) {
         /*
          Group 1 The number part of the string.
          Group 2 The base type, should be `h`, `d` or `o` if given!.
@@ -294,16 +289,15 @@ static void convertPPLStyleNumbersToBase10(std::string& str) {
 // MARK: - Public Methods
 
 std::string Calc::evaluateMathExpression(const std::string& str) {
-    std::regex re;
-    std::smatch match;
+    const Patterns &patterns = Patterns::shared();
     
     if (!isExpresionValid(str)) return str;
     
     std::string expression = str;
     convertPPLStyleNumbersToBase10(expression);
     
-    expression = regex_replace(expression, std::regex(R"(e)"), "2.71828182845904523536028747135266250");
-    expression = regex_replace(expression, std::regex(R"(π|pi)"), "3.14159265358979323846264338327950288");
+    expression = regex_replace(expression, patterns.euler, "2.71828182845904523536028747135266250");
+    expression = regex_replace(expression, patterns.pi, "3.14159265358979323846264338327950288");
     
     strip(expression);
     
@@ -322,7 +316,7 @@ std::string Calc::evaluateMathExpression(const std::string& str) {
 }
 
 std::string Calc::parse(const std::string& str) {
-    std::regex re;
+    const Patterns &patterns = Patterns::shared();
     std::smatch match;
     std::string newstr = str;
     
@@ -337,8 +331,9 @@ std::string Calc::parse(const std::string& str) {
      \`1+2*3`:32h
      \`1+2*3`:-32d
      */
-    re = R"(\\`([^`]+)`(?::(?:(-)?(\d+)([bodh])?|([fcr])))?)";
-    while (regex_search(str, match, re)) {
+    if (str.find("\\`") == std::string::npos) return str;
+    
+    while (regex_search(str, match, patterns.calc)) {
         
         std::string matched = match.str();
         
@@ -347,8 +342,8 @@ std::string Calc::parse(const std::string& str) {
         std::string expression;
         int scale = -1;
         
-        matched = regex_replace(matched, std::regex(R"(e)"), "2.71828182845904523536028747135266250");
-        matched = regex_replace(matched, std::regex(R"(π)"), "3.14159265358979323846264338327950288");
+        matched = regex_replace(matched, patterns.euler, "2.71828182845904523536028747135266250");
+        matched = regex_replace(matched, patterns.piSymbol, "3.14159265358979323846264338327950288");
         
         strip(matched);
   
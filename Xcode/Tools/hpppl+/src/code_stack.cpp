@@ -22,18 +22,22 @@
 
 #include "code_stack.hpp"
 #include "common.hpp"
+#include "patterns.hpp"
 
 #include <regex>
+#include <vector>
 
 using hppplplus::CodeStack;
+using hppplplus::Patterns;
 
 std::string CodeStack::parse(const std::string& str) {
-    std::regex re;
+    const std::regex &re = Patterns::shared().codeStack;
     std::smatch match;
     std::string::const_iterator it;
     std::string output = str;
     
-    re = R"(__PUSH__`([^`]*)`|__POP__|__TOP__)";
+    if (output.find("__") == std::string::npos) return output;
+    
     it = output.cbegin();
     while (std::regex_search(it, output.cend(), match, re)) {
         if (match.str() == "__POP__") {
@@ -64,3 +68,33 @@ std::string CodeStack::parse(const std::string& str) {
     
     return output;
 }
+
+void CodeStack::save(ArchiveWriter &archive) const {
+    auto stack = _stack;
+    std::vector<std::string> contents;
+    
+    while (!stack.empty()) {
+        contents.push_back(stack.top());
+        stack.pop();
+    }
+    
+    archive.write(contents.size());
+    for (auto it = contents.rbegin(); it != contents.rend(); ++it) {
+        archive.write(*it);
+    }
+}
+
+bool CodeStack::load(ArchiveReader &archive) {
+    size_t count = 0;
+    std::stack<std::string> stack;
+    
+    if (!archive.read(count)) return false;
+    for (size_t i = 0; i < count; ++i) {
+        std::string code;
+        if (!archive.read(code)) return false;
+        stack.push(code);
+    }
+    
+    _stack = std::move(stack);
+    return true;
+}
@@ -25,11 +25,16 @@
 #include <stack>
 #include <string>
 
+#include "archive.hpp"
+
 namespace hppplplus {
     class CodeStack {
     public:
         std::string parse(const std::string& str);
         
+        void save(ArchiveWriter &archive) const;
+        bool load(ArchiveReader &archive);
+        
     private:
         std::stack<std::string> _stack;
     };
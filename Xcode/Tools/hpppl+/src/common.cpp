@@ -21,38 +21,45 @@
 // SOFTWARE.
 
 #include "common.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 
 #include <sstream>
 #include <algorithm>
 #include <regex>
 
 
-using hppplplus::Singleton;
-
-static bool _failed = false;
+using hppplplus::TranslationContext;
 
 bool hasErrors(void) {
-    return _failed;
+    TranslationContext *context = TranslationContext::current();
+    return context && context->failed;
+}
+
+
+std::ostream &diagnostics(void) {
+    TranslationContext *context = TranslationContext::current();
+    return context ? *context->diagnostics : std::cerr;
 }
 
 std::ostream &operator<<(std::ostream &os, MessageType type) {
-    Singleton *singlenton = Singleton::shared();
+    TranslationContext *context = TranslationContext::current();
 
-    if (!singlenton->currentSourceFilePath().empty()) {
-        os << "📄 " << singlenton->currentSourceFilePath().filename().string() << ":";
-        os << singlenton->currentLineNumber() << " ";
+    if (context && !context->currentSourceFilePath().empty()) {
+        os << "📄 " << context->currentSourceFilePath().filename().string() << ":";
+        os << context->currentLineNumber() << " ";
     }
 
+    if (context && type != MessageType::Verbose) context->messages++;
+
     switch (type) {
         case MessageType::Error:
             os << "❌ error: ";
-            _failed = true;
+            if (context) context->failed = true;
             break;
             
         case MessageType::CriticalError:
             os << "🛑 critical error: ";
-            _failed = true;
+            if (context) context->failed = true;
             break;
 
         case MessageType::Warning:
@@ -35,7 +35,6 @@
 #include <fstream>
 #include <filesystem>
 
-#include "singleton.hpp"
 
 
 //#define basename(path)  path.string().substr(path.string().find_last_of("/") + 1)
@@ -52,7 +51,12 @@ enum class MessageType {
 };
 
 
+// Whether an error has been reported against the translation context current on this thread.
 bool hasErrors(void);
+
+// Where the translation context current on this thread reports to, std::cerr when there is none.
+std::ostream &diagnostics(void);
+
 std::ostream &operator<<(std::ostream &os, MessageType type);
 
 std::string &ltrim(std::string &str);
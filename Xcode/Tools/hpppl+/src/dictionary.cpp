@@ -21,43 +21,38 @@
 // SOFTWARE.
 
 #include "dictionary.hpp"
+#include "strings.hpp"
+#include "patterns.hpp"
 
 using hppplplus::Dictionary;
-
-static std::string pattern = R"(\bdictionary +([^\r\n\t\f\v@]+) +(@)?\b([a-z_]\w*(?:::[a-z_]\w*)*);)";
+using hppplplus::Patterns;
 
 bool Dictionary::isDictionaryDefinition(const std::string &str) {
-    return regex_search(str, std::regex(pattern, std::regex_constants::icase));
+    if (!containsIgnoringCase(str, "dictionary")) return false;
+    return regex_search(str, Patterns::shared().dictionary);
 }
 
 std::string Dictionary::removeDictionaryDefinition(const std::string& str) {
-    return std::regex_replace(str, std::regex(pattern, std::regex_constants::icase), "");
+    return std::regex_replace(str, Patterns::shared().dictionary, "");
 }
 
-bool Dictionary::proccessDictionaryDefinition(const std::string &str) {
-    std::regex re;
+bool Dictionary::proccessDictionaryDefinition(const std::string &str, TranslationContext &context) {
     std::smatch match;
     std::string code;
     
     code = str;
     
     Aliases::TIdentity identity;
-    identity.scope = Singleton::shared()->scopeDepth;
+    identity.scope = context.scopeDepth;
     identity.type = Aliases::Type::Alias;
     
-    std::string pattern;
-    
-    pattern = R"(\bdictionary +([^\r\n\t\f\v@]+) +(@)?\b([a-z_]\w*(?:::[a-z_]\w*)*);)";
-    
-    if (regex_search(code, match, std::regex(pattern, std::regex_constants::icase))) {
+    if (regex_search(code, match, Patterns::shared().dictionary)) {
         
-        identity.scope = match[2].matched ? 0 : Singleton::shared()->scopeDepth;
+        identity.scope = match[2].matched ? 0 : context.scopeDepth;
 
         std::string s = match[1].str();
         
-        pattern = R"(([a-z_]\w*)([^\r\n\t\f\v ,:=]+)?(?: *:= *([^\r\n\t\f\v ,]+))?)";
-        re = std::regex(pattern, std::regex_constants::icase);
-        for (auto it = std::sregex_iterator(s.begin(), s.end(), re); it != std::sregex_iterator(); it++) {
+        for (auto it = std::sregex_iterator(s.begin(), s.end(), Patterns::shared().dictionaryEntry); it != std::sregex_iterator(); it++) {
             identity.identifier = match[3].str() + "." + it->str(1);
 
             std::string alias = match.str(3), name = it->str(1), sufix = it->str(2), value = it->str(3);
@@ -75,7 +70,7 @@ bool Dictionary::proccessDictionaryDefinition(const std::string &str) {
                 identity.real = alias;
             }
             
-            Singleton::shared()->aliases.append(identity);
+            context.aliases.append(identity);
         }
         return true;
     }
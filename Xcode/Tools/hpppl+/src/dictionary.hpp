@@ -26,14 +26,14 @@
 #include <vector>
 #include <regex>
 
-#include "singleton.hpp"
+#include "translation_context.hpp"
 
 namespace hppplplus {
     class Dictionary {
     public:
         static bool isDictionaryDefinition(const std::string& str);
         static std::string removeDictionaryDefinition(const std::string& str);
-        static bool proccessDictionaryDefinition(const std::string& str);
+        static bool proccessDictionaryDefinition(const std::string& str, TranslationContext &context);
         
     private:
     };
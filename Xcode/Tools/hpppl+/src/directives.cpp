@@ -21,30 +21,31 @@
 // SOFTWARE.
 
 #include "directives.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 #include "common.hpp"
 #include "calc.hpp"
+#include "patterns.hpp"
 
 #include <regex>
 #include <sstream>
 #include <fstream>
 #include <cctype>
+#include <algorithm>
 
 using hppplplus::Directives;
-using hppplplus::Singleton;
-
-static Singleton *_singleton  = Singleton::shared();
+using hppplplus::Patterns;
 
 std::string Directives::parse(const std::string& str) {
     std::string s;
-    std::regex re;
+    const Patterns &patterns = Patterns::shared();
     std::smatch match;
     std::sregex_token_iterator it;
     std::sregex_token_iterator end;
     Aliases::TIdentity  identity;
     filename = std::string("");
 
-    
+    // Every directive begins with `{$`, so a line without one has nothing to parse.
+    if (str.find("{$") == std::string::npos) return str;
     
     if (disregard == false) {
         /*
@@ -52,18 +53,17 @@ std::string Directives::parse(const std::string& str) {
          Group  0 {$DEFINE NAME}
                 1 NAME
          */
-        re = std::regex(R"(^ *\{\$DEFINE +([a-z\d_]+)\})", std::regex_constants::icase);
-        if (std::regex_search(str, match, re)) {
+        if (std::regex_search(str, match, patterns.define)) {
             identity.identifier = match.str(1);
             identity.real = "1";
             
             identity.scope = 0;
             identity.type = Aliases::Type::CompileTimeSymbol;
             
-            identity.real = _singleton->aliases.resolveAllAliasesInText(identity.real);
+            identity.real = _context.aliases.resolveAllAliasesInText(identity.real);
             identity.real = Calc::evaluateMathExpression(identity.real);
             
-            _singleton->aliases.append(identity);
+            _context.aliases.append(identity);
             return "";
         }
  
@@ -72,9 +72,8 @@ std::string Directives::parse(const std::string& str) {
          Group  0 {$UNDEF NAME}
                 1 NAME
          */
-        re = std::regex(R"(^ *\{\$UNDEF +([a-z\d_]+)\})", std::regex_constants::icase);
-        if (std::regex_search(str, match, re)) {
-            _singleton->aliases.remove(match[1].str());
+        if (std::regex_search(str, match, patterns.undef)) {
+            _context.aliases.remove(match[1].str());
             return "";
         }
 
@@ -83,10 +82,9 @@ std::string Directives::parse(const std::string& str) {
          Group  0 {$IFDEF NAME}
                 1 NAME
          */
-        re = std::regex(R"(^ *\{\$IFDEF +([a-z\d_]+) *\} *$)", std::regex_constants::icase);
-        if (std::regex_search(str, match, re)) {
+        if (std::regex_search(str, match, patterns.ifdef)) {
             identity.identifier = match[1].str();
-            disregard = !_singleton->aliases.identifierExists(identity.identifier);
+            disregard = !_context.aliases.identifierExists(identity.identifier);
             return "";
         }
         
@@ -95,20 +93,28 @@ std::string Directives::parse(const std::string& str) {
          Group  0 {$IFNDEF NAME}
                 1 NAME
          */
-        re = std::regex(R"(^ *\{\$IFNDEF +([a-z\d_]+) *\} *$)", std::regex_constants::icase);
-        if (std::regex_search(str, match, re)) {
+        if (std::regex_search(str, match, patterns.ifndef)) {
             identity.identifier = match[1].str();
-            disregard = _singleton->aliases.identifierExists(identity.identifier);
+            disregard = _context.aliases.identifierExists(identity.identifier);
+            return "";
+        }
+        
+        /*
+         eg. {$ONCE}
+         The file is only included the first time it is referenced.
+         */
+        if (std::regex_search(str, patterns.once)) {
+            _context.includes.guard(_context.currentSourceFilePath());
             return "";
         }
     }
     
-    if (regex_search(str, std::regex(R"(^ *\{\$ELSE\} *$)", std::regex_constants::icase))) {
+    if (regex_search(str, patterns.elseDirective)) {
         disregard = !disregard;
         return "";
     }
     
-    if (regex_search(str, std::regex(R"(^ *\{\$ENDIF\} *$)", std::regex_constants::icase))) {
+    if (regex_search(str, patterns.endifDirective)) {
         disregard = false;
         return "";
     }
@@ -116,28 +122,54 @@ std::string Directives::parse(const std::string& str) {
     return str;
 }
 
-bool Directives::isIncludeDirective(const std::string& str) {
-    static const std::regex re(
-        R"(\{\$(?:INCLUDE|I) +[\w \-_~,;\[\]\(\).']+ *\})",
-        std::regex_constants::icase
-    );
+size_t Directives::skip(std::string_view code, size_t pos, long &lines) {
+    const Patterns &patterns = Patterns::shared();
+    int depth = 0;
+    lines = 0;
+    
+    for (size_t found = code.find("{$", pos); found != std::string_view::npos; found = code.find("{$", pos)) {
+        size_t start = code.rfind('\n', found);
+        start = start == std::string_view::npos ? 0 : start + 1;
+        size_t end = code.find('\n', found);
+        if (end == std::string_view::npos) end = code.length();
+        
+        lines += std::count(code.begin() + pos, code.begin() + start, '\n') + 1;
+        pos = end < code.length() ? end + 1 : end;
+        
+        // Only a line holding a directive is ever matched against one.
+        std::string line(code.substr(start, end - start));
+        
+        if (std::regex_search(line, patterns.ifdef) || std::regex_search(line, patterns.ifndef)) {
+            depth++;
+            continue;
+        }
+        
+        if (std::regex_search(line, patterns.endifDirective)) {
+            if (depth-- > 0) continue;
+            disregard = false;
+            return pos;
+        }
+        
+        if (depth == 0 && std::regex_search(line, patterns.elseDirective)) {
+            disregard = false;
+            return pos;
+        }
+    }
+    
+    lines += std::count(code.begin() + pos, code.end(), '\n');
+    return code.length();
+}
 
-    return std::regex_search(str, re);
+bool Directives::isIncludeDirective(const std::string& str) {
+    return std::regex_search(str, Patterns::shared().include);
 }
 
 std::filesystem::path Directives::extractIncludeDirective(const std::string& str) {
     std::smatch match;
     std::filesystem::path path;
-    
-    auto re = std::regex(
-        R"(\{\$(?:INCLUDE|I) +([\w \-_~,;\[\]\(\).']+) *\})",
-        std::regex_constants::icase
-    );
 
-    if (std::regex_search(str, match, re)) {
+    if (std::regex_search(str, match, Patterns::shared().includePath)) {
         path = std::filesystem::path(match.str(1));
     }
     return path;
 }
-
-
@@ -27,8 +27,11 @@
 #include <deque>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace hppplplus {
+    class TranslationContext;
+    
     class Directives {
     public:
         std::string filename;
@@ -40,10 +43,27 @@ namespace hppplplus {
         bool operators = true;
         bool logicalOperators = true;
         
+        // Directives define into, and test against, the aliases of the context.
+        explicit Directives(TranslationContext &context) : _context(context) {}
+        
         std::string parse(const std::string& str);
         
+        /*
+         Skips a disabled conditional region of `code` starting from `pos`, scanning only
+         for the `{$` of a directive rather than parsing each line. Nested {$IFDEF} and
+         {$IFNDEF} blocks are skipped whole, the region ends at the {$ELSE} or {$ENDIF}
+         matching the one that disabled it.
+         
+         Returns the position just past the line ending the region, or the end of `code`
+         if none does, with `lines` set to the number of lines skipped.
+         */
+        size_t skip(std::string_view code, size_t pos, long &lines);
+        
         static bool isIncludeDirective(const std::string& str);
         static std::filesystem::path extractIncludeDirective(const std::string& str);
+        
+    private:
+        TranslationContext &_context;
     };
     
 }
@@ -0,0 +1,66 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ The interface of an add-on built as a shared library rather than as an executable.
+ 
+ hpppl+ looks for lib<command>.dylib, or lib<command>.so, beside itself before running
+ <command>, and when it finds one exporting this interface calls it in-process, on the
+ thread including the file, rather than spawning the add-on. Only C is used, so an
+ add-on can be built with any compiler, or in any language, able to export C.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HPPPL_ADDON_ABI_VERSION 1
+
+/*
+ Memory handed back by an add-on. The add-on allocates `data` however it likes and sets
+ `release` to the function freeing it, which hpppl+ calls once done with the buffer.
+ */
+typedef struct hpppl_addon_buffer {
+    char *data;
+    size_t length;
+    void (*release)(struct hpppl_addon_buffer *buffer);
+} hpppl_addon_buffer;
+
+// The interface the add-on was built against, HPPPL_ADDON_ABI_VERSION.
+int hpppl_addon_abi_version(void);
+
+/*
+ Converts the file at `path` to PPL, given in `out`, with any messages given in `err`.
+ `argv` holds the arguments the add-on was given, ending with NULL. Returns 0 on
+ success, as the add-on would exit, having filled in both buffers either way.
+ 
+ Called from several threads at once, so it must keep no unguarded state.
+ */
+int hpppl_addon_convert(const char *path, const char *const *argv, hpppl_addon_buffer *out, hpppl_addon_buffer *err);
+
+#ifdef __cplusplus
+}
+#endif
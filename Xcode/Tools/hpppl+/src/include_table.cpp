@@ -0,0 +1,167 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "include_table.hpp"
+#include "translation_cache.hpp"
+#include "utf.hpp"
+
+#include <set>
+#include <cstring>
+
+using hppplplus::IncludeTable;
+
+namespace fs = std::filesystem;
+
+fs::path IncludeTable::canonical(const fs::path &path) {
+    std::error_code ec;
+    auto canonical = fs::weakly_canonical(path, ec);
+    if (ec) return fs::absolute(path).lexically_normal();
+    return canonical;
+}
+
+const std::string &IncludeTable::key(const fs::path &path) {
+    auto it = _canonical.find(path.string());
+    if (it == _canonical.end()) {
+        it = _canonical.emplace(path.string(), canonical(path)).first;
+    }
+    return it->second.native();
+}
+
+bool IncludeTable::exists(const fs::path &path) {
+    auto it = _exists.find(path.string());
+    if (it == _exists.end()) {
+        it = _exists.emplace(path.string(), fs::exists(path)).first;
+    }
+    return it->second;
+}
+
+std::optional<fs::path> IncludeTable::resolve(const fs::path &name, const std::deque<fs::path> &directories) {
+    if (!name.parent_path().empty()) {
+        if (exists(name)) return name;
+        return std::nullopt;
+    }
+    
+    for (const auto &directory : directories) {
+        auto path = directory / name;
+        if (exists(path)) return path;
+    }
+    return std::nullopt;
+}
+
+const hppplplus::SourceBuffer &IncludeTable::source(const fs::path &path) {
+    const std::string &canonical = key(path);
+    auto it = _sources.find(canonical);
+    if (it == _sources.end()) {
+        it = _sources.emplace(canonical, std::make_unique<SourceBuffer>(path)).first;
+    }
+    return *it->second;
+}
+
+std::string_view IncludeTable::load(const fs::path &path) {
+    return source(path).data();
+}
+
+std::string_view IncludeTable::decode(const fs::path &path) {
+    const SourceBuffer &buffer = source(path);
+    if (buffer.bom() == utf::BOM::none) return buffer.data();
+    
+    const std::string &canonical = key(path);
+    auto it = _decoded.find(canonical);
+    if (it == _decoded.end()) {
+        // UTF-16 in the byte order of the machine, up to any null, as utf::load reads it.
+        std::wstring wstr;
+        std::string_view data = buffer.data().substr(2);
+        for (size_t i = 0; i + 1 < data.length(); i += 2) {
+            char16_t ch;
+            memcpy(&ch, data.data() + i, sizeof(ch));
+            if (ch == 0) break;
+            wstr += static_cast<wchar_t>(ch);
+        }
+        it = _decoded.emplace(canonical, utf::to_string(wstr)).first;
+    }
+    return it->second;
+}
+
+utf::BOM IncludeTable::bom(const fs::path &path) {
+    return source(path).bom();
+}
+
+const std::string &IncludeTable::digest(const fs::path &path) {
+    const std::string &canonical = key(path);
+    auto it = _digests.find(canonical);
+    if (it == _digests.end()) {
+        std::string digest = exists(path) ? TranslationCache::digest(load(path)) : "-";
+        it = _digests.emplace(canonical, digest).first;
+    }
+    return it->second;
+}
+
+void IncludeTable::guard(const fs::path &path) {
+    _guarded.insert(key(path));
+}
+
+void IncludeTable::reset(void) {
+    _canonical.clear();
+    _exists.clear();
+    _sources.clear();
+    _decoded.clear();
+    _digests.clear();
+    _included.clear();
+    _guarded.clear();
+}
+
+bool IncludeTable::enter(const fs::path &path) {
+    const std::string &canonical = key(path);
+    
+    if (_included.contains(canonical) && (once || _guarded.contains(canonical))) return false;
+    _included.insert(canonical);
+    return true;
+}
+
+void IncludeTable::save(ArchiveWriter &archive) const {
+    // Sorted, so the same files always archive the same.
+    std::set<std::string> excluded(_guarded.begin(), _guarded.end());
+    if (once) excluded.insert(_included.begin(), _included.end());
+    
+    archive.write(once);
+    archive.write(excluded.size());
+    for (const auto &path : excluded) archive.write(path);
+}
+
+bool IncludeTable::load(ArchiveReader &archive) {
+    size_t count = 0;
+    bool once = false;
+    std::unordered_set<std::string> excluded;
+    
+    archive.read(once);
+    if (!archive.read(count)) return false;
+    for (size_t i = 0; i < count; ++i) {
+        std::string path;
+        if (!archive.read(path)) return false;
+        excluded.insert(path);
+    }
+    
+    this->once = once;
+    _guarded = excluded;
+    _included.insert(excluded.begin(), excluded.end());
+    return true;
+}
@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+
+#include "archive.hpp"
+#include "source_buffer.hpp"
+
+namespace hppplplus {
+    /*
+     The files included over a build, keyed by canonical path.
+     
+     Whether a file exists, where a name resolves to and what a file contains are
+     each looked up once per process, each file being read, or mapped, only once. The table also tracks which files have been
+     included, so a file guarded by {$ONCE}, or any file when `once` is set, is only
+     included the first time it is referenced.
+     */
+    class IncludeTable {
+    public:
+        bool once = false;
+        
+        static std::filesystem::path canonical(const std::filesystem::path &path);
+        
+        bool exists(const std::filesystem::path &path);
+        
+        // The first of `directories` holding `name`, or `name` itself when it already has a directory.
+        std::optional<std::filesystem::path> resolve(const std::filesystem::path &name, const std::deque<std::filesystem::path> &directories);
+        
+        // The contents of a file as UTF-8, and as decoded according to its byte order mark.
+        std::string_view load(const std::filesystem::path &path);
+        std::string_view decode(const std::filesystem::path &path);
+        
+        utf::BOM bom(const std::filesystem::path &path);
+        
+        // The digest of the contents of a file, as TranslationCache::fileDigest gives.
+        const std::string &digest(const std::filesystem::path &path);
+        
+        void guard(const std::filesystem::path &path);
+        
+        // Forgets every file, so that any changed since are read again.
+        void reset(void);
+        
+        /*
+         Records that the file is being included, returning false when it has been
+         included before and is only to be included once.
+         */
+        bool enter(const std::filesystem::path &path);
+        
+        // Saves the files that are not to be included again.
+        void save(ArchiveWriter &archive) const;
+        bool load(ArchiveReader &archive);
+        
+    private:
+        std::unordered_map<std::string, std::filesystem::path> _canonical;
+        std::unordered_map<std::string, bool> _exists;
+        std::unordered_map<std::string, std::unique_ptr<SourceBuffer>> _sources;
+        std::unordered_map<std::string, std::string> _decoded;
+        std::unordered_map<std::string, std::string> _digests;
+        
+        std::unordered_set<std::string> _included;
+        std::unordered_set<std::string> _guarded;
+        
+        const std::string &key(const std::filesystem::path &path);
+        const SourceBuffer &source(const std::filesystem::path &path);
+    };
+}
@@ -0,0 +1,210 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "json.hpp"
+
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+
+typedef std::string_view::size_type size_type;
+
+static void skipWhitespace(std::string_view text, size_type &pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) pos++;
+}
+
+static void appendUTF8(std::string &str, unsigned int codepoint) {
+    if (codepoint < 0x80) {
+        str += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        str += static_cast<char>(0xC0 | (codepoint >> 6));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        str += static_cast<char>(0xE0 | (codepoint >> 12));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        str += static_cast<char>(0xF0 | (codepoint >> 18));
+        str += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+static bool parseHex(std::string_view text, size_type &pos, unsigned int &value) {
+    if (pos + 4 > text.size()) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = text[pos++];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+static bool parseString(std::string_view text, size_type &pos, std::string &str) {
+    if (pos >= text.size() || text[pos] != '"') return false;
+    pos++;
+    
+    while (pos < text.size()) {
+        char c = text[pos++];
+        if (c == '"') return true;
+        if (c != '\\') {
+            str += c;
+            continue;
+        }
+        
+        if (pos >= text.size()) return false;
+        c = text[pos++];
+        switch (c) {
+            case '"': str += '"'; break;
+            case '\\': str += '\\'; break;
+            case '/': str += '/'; break;
+            case 'b': str += '\b'; break;
+            case 'f': str += '\f'; break;
+            case 'n': str += '\n'; break;
+            case 'r': str += '\r'; break;
+            case 't': str += '\t'; break;
+            case 'u': {
+                unsigned int codepoint;
+                if (!parseHex(text, pos, codepoint)) return false;
+                
+                // A high surrogate is only meaningful followed by a low one.
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    unsigned int low;
+                    if (text.substr(pos, 2) != "\\u") return false;
+                    pos += 2;
+                    if (!parseHex(text, pos, low) || low < 0xDC00 || low > 0xDFFF) return false;
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUTF8(str, codepoint);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+static bool parseValue(std::string_view text, size_type &pos, json::value_t &value) {
+    if (pos >= text.size()) return false;
+    
+    if (text[pos] == '"') {
+        value.type = json::value_t::Type::String;
+        return parseString(text, pos, value.string);
+    }
+    
+    for (const auto &literal : {std::string_view("true"), std::string_view("false"), std::string_view("null")}) {
+        if (text.substr(pos, literal.size()) != literal) continue;
+        pos += literal.size();
+        if (literal == "null") {
+            value.type = json::value_t::Type::Null;
+        } else {
+            value.type = json::value_t::Type::Boolean;
+            value.boolean = literal == "true";
+        }
+        return true;
+    }
+    
+    size_type end = pos;
+    while (end < text.size() && (std::isdigit(static_cast<unsigned char>(text[end])) || text[end] == '-' || text[end] == '+' || text[end] == '.' || text[end] == 'e' || text[end] == 'E')) end++;
+    if (end == pos) return false;
+    
+    std::string number(text.substr(pos, end - pos));
+    char *last = nullptr;
+    value.type = json::value_t::Type::Number;
+    value.number = std::strtod(number.c_str(), &last);
+    if (last != number.c_str() + number.size()) return false;
+    
+    pos = end;
+    return true;
+}
+
+std::optional<json::object_t> json::parse(std::string_view text) {
+    object_t object;
+    size_type pos = 0;
+    
+    skipWhitespace(text, pos);
+    if (pos >= text.size() || text[pos++] != '{') return std::nullopt;
+    
+    skipWhitespace(text, pos);
+    if (pos < text.size() && text[pos] == '}') {
+        pos++;
+    } else {
+        while (true) {
+            std::string key;
+            value_t value;
+            
+            skipWhitespace(text, pos);
+            if (!parseString(text, pos, key)) return std::nullopt;
+            skipWhitespace(text, pos);
+            if (pos >= text.size() || text[pos++] != ':') return std::nullopt;
+            skipWhitespace(text, pos);
+            if (!parseValue(text, pos, value)) return std::nullopt;
+            object[key] = value;
+            
+            skipWhitespace(text, pos);
+            if (pos >= text.size()) return std::nullopt;
+            if (text[pos] == '}') {
+                pos++;
+                break;
+            }
+            if (text[pos++] != ',') return std::nullopt;
+        }
+    }
+    
+    skipWhitespace(text, pos);
+    if (pos != text.size()) return std::nullopt;
+    
+    return object;
+}
+
+std::string json::quote(std::string_view str) {
+    std::string quoted = "\"";
+    
+    for (char c : str) {
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\b': quoted += "\\b"; break;
+            case '\f': quoted += "\\f"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+                    quoted += escape;
+                } else {
+                    quoted += c;
+                }
+                break;
+        }
+    }
+    
+    return quoted + "\"";
+}
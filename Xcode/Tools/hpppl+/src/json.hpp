@@ -20,42 +20,30 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include "singleton.hpp"
-
-using hppplplus::Singleton;
-
-// Define the static Singleton pointer
-Singleton *Singleton::_shared = NULL;
-
-Singleton *Singleton::shared() {
-    if (_shared == NULL) {
-        _shared = new Singleton();
-    }
-    return(_shared);
-}
-
-void Singleton::incrementLineNumber(void) {
-    ++_currentline;
-}
-
-long Singleton::currentLineNumber(void) {
-    return _currentline;
-}
-
-std::filesystem::path Singleton::currentSourceFilePath(void) {
-    if (_paths.empty()) return "";
-    return _paths.back();
-}
-
-
-
-void Singleton::pushPath(const std::filesystem::path &path) {
-    _paths.push_back(path.lexically_normal());
-    _lines.push_back(_currentline);
-    _currentline = 1;
-}
-void Singleton::popPath(void) {
-    _currentline = _lines.back();
-    _paths.pop_back();
-    _lines.pop_back();
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <optional>
+
+namespace json {
+    /*
+     The requests read in server mode are flat objects, so values are only ever null,
+     a boolean, a number or a string.
+     */
+    struct value_t {
+        enum class Type { Null, Boolean, Number, String } type = Type::Null;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+    };
+    
+    typedef std::map<std::string, value_t> object_t;
+    
+    // Returns nothing when the text is not a single flat object.
+    std::optional<object_t> parse(std::string_view text);
+    
+    // The string as a JSON string, quotes included.
+    std::string quote(std::string_view str);
 }
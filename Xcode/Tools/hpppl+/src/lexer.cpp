@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lexer.hpp"
+
+#include <cctype>
+
+using hppplplus::Lexer;
+
+static bool isWordCharacter(const char c) {
+    return isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+static bool isDigit(const char c) {
+    return isdigit(static_cast<unsigned char>(c));
+}
+
+static bool isSpace(const char c) {
+    return isspace(static_cast<unsigned char>(c));
+}
+
+std::vector<Lexer::TToken> Lexer::tokenize(std::string_view str) {
+    std::vector<TToken> tokens;
+    size_t i = 0;
+    
+    while (i < str.length()) {
+        size_t start = i;
+        const char c = str[i];
+        Kind kind = Kind::Symbol;
+        
+        if (isWordCharacter(c)) {
+            kind = Kind::Word;
+            while (++i < str.length() && isWordCharacter(str[i]));
+        } else if (isDigit(c)) {
+            kind = Kind::Number;
+            while (++i < str.length() && isDigit(str[i]));
+        } else if (isSpace(c)) {
+            kind = Kind::Space;
+            while (++i < str.length() && isSpace(str[i]));
+        } else if (c == '/' && i + 1 < str.length() && str[i + 1] == '/') {
+            kind = Kind::Comment;
+            i = str.length();
+        } else if (c == '"') {
+            // A string ends at the first quote not preceded by a backslash, an unterminated quote is just a symbol.
+            size_t end = i + 1;
+            while (end < str.length() && (str[end] != '"' || str[end - 1] == '\\')) ++end;
+            if (end < str.length()) {
+                kind = Kind::String;
+                i = end + 1;
+            } else {
+                ++i;
+            }
+        } else {
+            ++i;
+        }
+        
+        tokens.push_back({kind, str.substr(start, i - start)});
+    }
+    
+    return tokens;
+}
+
+Lexer::TLine Lexer::split(std::string_view str) {
+    TLine line;
+    line.code.reserve(str.length());
+    
+    for (const auto &token : tokenize(str)) {
+        switch (token.kind) {
+            case Kind::String:
+                line.strings.emplace_back(token.text);
+                line.code.append("\"\"");
+                break;
+                
+            case Kind::Comment: {
+                // Strings within the comment are blanked out too, the comment is kept as it then reads.
+                auto comment = split(token.text.substr(2));
+                line.strings.splice(line.strings.end(), comment.strings);
+                line.comment = comment.code + comment.comment;
+                line.code.append("//");
+                break;
+            }
+                
+            default:
+                line.code.append(token.text);
+                break;
+        }
+    }
+    
+    return line;
+}
+
+std::string Lexer::rewriteWords(std::string_view str, const std::function<void(std::string_view word, std::string &out)> &rewrite) {
+    std::string out;
+    out.reserve(str.length() + 16);
+    
+    size_t i = 0;
+    while (i < str.length()) {
+        if (!isWordCharacter(str[i])) {
+            size_t start = i;
+            while (++i < str.length() && !isWordCharacter(str[i]));
+            out.append(str.substr(start, i - start));
+            continue;
+        }
+        
+        size_t start = i;
+        while (++i < str.length() && isWordCharacter(str[i]));
+        rewrite(str.substr(start, i - start), out);
+    }
+    
+    return out;
+}
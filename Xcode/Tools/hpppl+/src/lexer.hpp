@@ -0,0 +1,75 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <functional>
+
+namespace hppplplus {
+    /*
+     A single pass lexer for a line of PPL+.
+     
+     Tokens are views into the line they were produced from, classified so that the
+     stages of translation can tell code apart from strings and comments without
+     rescanning the line for each.
+     */
+    class Lexer {
+    public:
+        enum class Kind {
+            Word,       // a run of letters and underscores
+            Number,     // a run of digits
+            Space,      // a run of whitespace
+            String,     // a double-quoted string, including its quotes
+            Comment,    // a `//` comment, including its `//`, to the end of the line
+            Symbol      // any other single character
+        };
+        
+        typedef struct TToken {
+            Kind kind;
+            std::string_view text;
+        } TToken;
+        
+        typedef struct TLine {
+            std::string code;                   // the line with strings blanked out as `""` and the comment text removed
+            std::list<std::string> strings;     // the strings blanked out from the code, in order
+            std::string comment;                // the comment text following `//`, its strings also blanked out
+        } TLine;
+        
+        static std::vector<TToken> tokenize(std::string_view str);
+        
+        /*
+         Splits a line into its code, strings and comment in one pass, so the code can be
+         translated without disturbing the content of either.
+         */
+        static TLine split(std::string_view str);
+        
+        /*
+         Rebuilds the string, passing each word to `rewrite` which appends whatever is to
+         take its place. All other tokens are copied as they are.
+         */
+        static std::string rewriteWords(std::string_view str, const std::function<void(std::string_view word, std::string &out)> &rewrite);
+    };
+}
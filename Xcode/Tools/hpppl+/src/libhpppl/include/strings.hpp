@@ -118,4 +118,16 @@ std::string capitalizeWords(const std::string& input, const std::unordered_set<s
  */
 std::vector<std::string> splitCommas(const std::string& input);
 
+/**
+ * @brief Checks whether a string contains a substring, ignoring ASCII case.
+ *
+ * Intended as a cheap test ahead of a case-insensitive regular expression, so the
+ * expression is only run on lines that could possibly match.
+ *
+ * @param str The string to search.
+ * @param substr The substring to look for.
+ * @return true if `substr` occurs anywhere in `str`.
+ */
+bool containsIgnoringCase(const std::string& str, const std::string& substr);
+
 int countLeadingCharacters(const std::string &str, const char character);
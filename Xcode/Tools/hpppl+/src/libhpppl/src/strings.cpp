@@ -52,27 +52,27 @@ std::list<std::string> preserveStrings(const std::string& str) {
 
 
 std::string restoreStrings(const std::string& str, std::list<std::string>& strings) {
-    static const std::regex re(R"("[^"]*")");
-
     if (strings.empty()) return str;
 
     std::string result;
     std::size_t lastPos = 0;
 
     auto stringIt = strings.begin();
-    for (auto it = std::sregex_iterator(str.begin(), str.end(), re);
-         it != std::sregex_iterator() && stringIt != strings.end(); ++it, ++stringIt)
-    {
-        const std::smatch& match = *it;
+    while (stringIt != strings.end()) {
+        // Find the next quoted substring, the equivalent of matching "[^"]*"
+        std::size_t open = str.find('"', lastPos);
+        if (open == std::string::npos) break;
+        std::size_t close = str.find('"', open + 1);
+        if (close == std::string::npos) break;
 
         // Append the part before the match
-        result.append(str, lastPos, match.position() - lastPos);
+        result.append(str, lastPos, open - lastPos);
 
         // Append the preserved quoted string
-        result.append(*stringIt);
+        result.append(*stringIt++);
 
         // Update the last position
-        lastPos = match.position() + match.length();
+        lastPos = close + 1;
     }
 
     // Append the remaining part of the string after the last match
@@ -268,6 +268,13 @@ std::vector<std::string> splitCommas(const std::string& input) {
     return result;
 }
 
+bool containsIgnoringCase(const std::string& str, const std::string& substr) {
+    auto it = std::search(str.begin(), str.end(), substr.begin(), substr.end(), [](unsigned char a, unsigned char b) {
+        return std::tolower(a) == std::tolower(b);
+    });
+    return it != str.end() || substr.empty();
+}
+
 int countLeadingCharacters(const std::string &str, const char character) {
     int count = 0;
     for (const char ch : str) {  // Declare 'ch' as const
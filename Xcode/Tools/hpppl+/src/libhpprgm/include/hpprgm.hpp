@@ -26,8 +26,30 @@
 #include <fstream>
 #include <vector>
 #include <filesystem>
+#include <string>
+#include <string_view>
 
 namespace hpprgm {
+    typedef struct {
+        std::string name;   // of the file, without its .hpprgm extension
+        std::string prgm;
+    } TProgram;
+    
     void write(const std::filesystem::path& path, const std::string& prgm, const bool includeProgramName = false);
+    
+    /*
+     The size of the file that write would create at path, and its contents written
+     into out, which must hold that many bytes, returning the number written.
+     */
+    size_t size(const std::filesystem::path& path, std::string_view prgm, const bool includeProgramName = false);
+    size_t encode(const std::filesystem::path& path, std::string_view prgm, char *out, const bool includeProgramName = false);
+    
+    /*
+     Writes each program into directory, named as it gives, on up to threads threads
+     at once, or one per core when 0. Throws the first error met once every other
+     program has been written.
+     */
+    void write(const std::filesystem::path& directory, const std::vector<TProgram>& programs, const bool includeProgramName = false, unsigned threads = 0);
+    
     std::wstring source(const std::filesystem::path& path);
 }
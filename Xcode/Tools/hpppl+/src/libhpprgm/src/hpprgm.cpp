@@ -21,6 +21,20 @@
 // SOFTWARE.
 
 #include "hpprgm.hpp"
+#include "utf.hpp"
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cstring>
+#include <cerrno>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/uio.h>
+#endif
 
 // MARK: - Helper Functions
 
@@ -33,82 +47,54 @@ static inline std::vector<uint8_t> readBytes(const std::filesystem::path& path)
     return buf;
 }
 
-static inline void writeBytes(const std::filesystem::path& path, const std::vector<uint8_t>& data) {
+// Writes the header and the program after it with a single gathering write, neither copied.
+static void writeBytes(const std::filesystem::path& path, const std::vector<uint8_t>& header, const char *program, size_t length) {
+#if defined(_WIN32)
     std::ofstream f(path, std::ios::binary);
     if (!f) throw std::runtime_error("Cannot write file");
-    f.write((const char*)data.data(), data.size());
-}
-
-static inline std::vector<uint8_t> utf16le(const std::string& s)
-{
-    std::vector<uint8_t> out;
-    out.reserve(s.size() * 2); // worst case UTF-16 length
-
-    uint32_t code = 0;
-    int bytesNeeded = 0;
-
-    for (unsigned char c : s) {
-
-        if (bytesNeeded == 0) {
-            // Start of a new UTF-8 sequence
-            if (c <= 0x7F) {
-                // 1-byte ASCII
-                uint16_t v = c;
-                out.push_back(v & 0xFF);
-                out.push_back((v >> 8) & 0xFF);
-            }
-            else if ((c & 0xE0) == 0xC0) {
-                code = c & 0x1F;
-                bytesNeeded = 1;
-            }
-            else if ((c & 0xF0) == 0xE0) {
-                code = c & 0x0F;
-                bytesNeeded = 2;
-            }
-            else if ((c & 0xF8) == 0xF0) {
-                code = c & 0x07;
-                bytesNeeded = 3;
-            }
-            else {
-                // invalid UTF-8 start byte
-                continue;
-            }
+    f.write((const char*)header.data(), header.size());
+    f.write(program, length);
+    if (!f) throw std::runtime_error("Cannot write file");
+#else
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) throw std::runtime_error("Cannot write file");
+    
+    struct iovec parts[2] = {
+        { const_cast<uint8_t *>(header.data()), header.size() },
+        { const_cast<char *>(program), length }
+    };
+    struct iovec *part = parts;
+    int count = 2;
+    
+    while (count) {
+        ssize_t written = writev(fd, part, count);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            close(fd);
+            throw std::runtime_error("Cannot write file");
         }
-        else {
-            // continuation byte
-            if ((c & 0xC0) != 0x80) {
-                // invalid UTF-8 continuation
-                bytesNeeded = 0;
-                continue;
-            }
-
-            code = (code << 6) | (c & 0x3F);
-
-            if (--bytesNeeded == 0) {
-                if (code <= 0xFFFF) {
-                    // Direct UTF-16
-                    uint16_t v = static_cast<uint16_t>(code);
-                    out.push_back(v & 0xFF);
-                    out.push_back((v >> 8) & 0xFF);
-                }
-                else {
-                    // Surrogate pair
-                    code -= 0x10000;
-                    uint16_t high = 0xD800 + (code >> 10);
-                    uint16_t low  = 0xDC00 + (code & 0x3FF);
-
-                    out.push_back(high & 0xFF);
-                    out.push_back((high >> 8) & 0xFF);
-
-                    out.push_back(low & 0xFF);
-                    out.push_back((low >> 8) & 0xFF);
-                }
-            }
+        
+        // A short write resumes from where it stopped.
+        while (count && static_cast<size_t>(written) >= part->iov_len) {
+            written -= part->iov_len;
+            part++;
+            count--;
+        }
+        if (count) {
+            part->iov_base = static_cast<char *>(part->iov_base) + written;
+            part->iov_len -= written;
         }
     }
+    
+    if (close(fd) != 0) throw std::runtime_error("Cannot write file");
+#endif
+}
 
-    out.push_back(0);
-    out.push_back(0);
+// The UTF-16LE of s, null terminated.
+static inline std::vector<uint8_t> utf16le(const std::string& s)
+{
+    std::vector<uint8_t> out(utf::utf16le_size(s) + 2);
+    utf::encode_utf16le(s, reinterpret_cast<char *>(out.data()));
     return out;
 }
 
@@ -203,9 +189,11 @@ static std::vector<uint16_t> extractData(const std::vector<uint16_t>& hpprgm)
 }
 
 
-// MARK: - 📣 Public API functions
-
-void hpprgm::write(const std::filesystem::path& path, const std::string& prgm, const bool includeProgramName)
+/*
+ The header of a program of programSize bytes, which gives it the name of the file at
+ path when includeProgramName.
+ */
+static std::vector<uint8_t> header(const std::filesystem::path& path, const uint32_t programSize, const bool includeProgramName)
 {
     std::vector<uint8_t> header = {
         0x0C, 0, 0, 0, 0, 0, 0, 0,
@@ -224,18 +212,83 @@ void hpprgm::write(const std::filesystem::path& path, const std::string& prgm, c
         header.insert(header.end(), filename.begin(), filename.end());
     }
     
-    auto sourceCode = utf16le(prgm);
-    uint32_t programSize = static_cast<uint32_t>(sourceCode.size());
-    
     append32le(header, programSize);
+    return header;
+}
+
+// The program as UTF-16LE is null terminated.
+static inline size_t programSize(std::string_view prgm)
+{
+    return utf::utf16le_size(prgm) + 2;
+}
+
+static inline void encodeProgram(std::string_view prgm, char *out, const size_t size)
+{
+    utf::encode_utf16le(prgm, out);
+    out[size - 2] = 0;
+    out[size - 1] = 0;
+}
+
 
-    std::vector<uint8_t> out;
-    out.reserve((uint32_t)(header.size() + sourceCode.size()));
+// MARK: - 📣 Public API functions
+
+void hpprgm::write(const std::filesystem::path& path, const std::string& prgm, const bool includeProgramName)
+{
+    // Sized first, the program is encoded once, straight into the buffer it is written from.
+    size_t size = programSize(prgm);
+    auto head = header(path, static_cast<uint32_t>(size), includeProgramName);
     
-    out.insert(out.end(), header.begin(), header.end());
-    out.insert(out.end(), sourceCode.begin(), sourceCode.end());
+    std::unique_ptr<char[]> program(new char[size]);
+    encodeProgram(prgm, program.get(), size);
+    
+    writeBytes(path, head, program.get(), size);
+}
 
-    writeBytes(path, out);
+size_t hpprgm::size(const std::filesystem::path& path, std::string_view prgm, const bool includeProgramName)
+{
+    return header(path, 0, includeProgramName).size() + programSize(prgm);
+}
+
+size_t hpprgm::encode(const std::filesystem::path& path, std::string_view prgm, char *out, const bool includeProgramName)
+{
+    size_t size = programSize(prgm);
+    auto head = header(path, static_cast<uint32_t>(size), includeProgramName);
+    
+    std::memcpy(out, head.data(), head.size());
+    encodeProgram(prgm, out + head.size(), size);
+    return head.size() + size;
+}
+
+void hpprgm::write(const std::filesystem::path& directory, const std::vector<TProgram>& programs, const bool includeProgramName, unsigned threads)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, programs.size()));
+    
+    std::atomic<size_t> next = 0;
+    std::exception_ptr failure;
+    std::mutex mutex;
+    
+    auto work = [&] {
+        for (size_t i = next++; i < programs.size(); i = next++) {
+            try {
+                write(directory / (programs[i].name + ".hpprgm"), programs[i].prgm, includeProgramName);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (unsigned n = 1; n < threads; n++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    
+    if (failure) std::rethrow_exception(failure);
 }
 
 std::wstring hpprgm::source(const std::filesystem::path& path)
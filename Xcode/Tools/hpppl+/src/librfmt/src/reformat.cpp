@@ -179,8 +179,8 @@ static std::string insertNewlineBeforeWords(
 // MARK: - Utills
 
 
-static std::string reformatLine(const std::string& str, int indentationWidth) {
-    static int depth = 0;
+// The depth of nesting is carried from line to line of the one program being reformatted.
+static std::string reformatLine(const std::string& str, int indentationWidth, int &depth) {
     std::string output = str;
     
     std::regex tokenRegex(R"(\b(?:BEGIN|FOR|IF|WHILE|REPEAT|CASE|UNTIL|ELSE|IFERR)\b|END;)");
@@ -217,9 +217,10 @@ static std::string reformatAllLines(std::istringstream& iss, int indentationWidt
 {
     std::string str;
     std::string result;
+    int depth = 0;
     
     while(getline(iss, str)) {
-        result.append(reformatLine(str, indentationWidth));
+        result.append(reformatLine(str, indentationWidth, depth));
     }
     
     return result;
@@ -94,4 +94,22 @@ namespace utf {
     size_t size(std::string_view s);
     size_t size(std::wstring_view s);
     size_t size(std::u16string_view s);
+    
+    /*
+     The number of bytes s starts with that are ASCII, found a vector at a time with
+     AVX2, SSE2 or NEON where the target has them and a word at a time where not. Every
+     transcoder copies such runs straight across before decoding what follows them.
+     */
+    size_t ascii_length(std::string_view s);
+    
+    // Whether s is well-formed UTF-8, with no overlong forms, surrogates or code points past U+10FFFF.
+    bool valid(std::string_view s);
+    
+    /*
+     Encodes s as UTF-16LE into out, which must hold utf16le_size(s) bytes, returning
+     the number of bytes written. Characters outside the BMP become surrogate pairs, and
+     malformed sequences are dropped.
+     */
+    size_t utf16le_size(std::string_view s);
+    size_t encode_utf16le(std::string_view s, char *out);
 };
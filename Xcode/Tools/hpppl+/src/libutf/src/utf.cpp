@@ -23,8 +23,138 @@
 #include "utf.hpp"
 
 #include <vector>
+#include <bit>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__AVX2__)
+    #define UTF_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    #define UTF_SSE2
+    #include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+    #define UTF_NEON
+    #include <arm_neon.h>
+#endif
 
 namespace utf {
+    // MARK: - Kernels
+    
+    /*
+     Widens ASCII to UTF-16LE, each byte followed by a zero, writing twice length bytes
+     to out.
+     */
+    static void widen(const char *s, size_t length, char *out)
+    {
+        size_t i = 0;
+        
+#if defined(UTF_AVX2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 2), _mm256_cvtepu8_epi16(bytes));
+        }
+#elif defined(UTF_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= length; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2 + 16), _mm_unpackhi_epi8(bytes, zero));
+        }
+#elif defined(UTF_NEON)
+        for (; i + 16 <= length; i += 16) {
+            uint8x16x2_t units = {{ vld1q_u8(reinterpret_cast<const uint8_t *>(s + i)), vdupq_n_u8(0) }};
+            vst2q_u8(reinterpret_cast<uint8_t *>(out + i * 2), units);
+        }
+#endif
+        
+        for (; i < length; i++) {
+            out[i * 2] = s[i];
+            out[i * 2 + 1] = 0;
+        }
+    }
+    
+    // Decodes UTF-8 as to_wstring always has, one unit per character of up to three bytes.
+    template <typename T>
+    static size_t decode(std::string_view s, T *out)
+    {
+        T *start = out;
+        size_t i = 0;
+        
+        while (i < s.size()) {
+            size_t run = ascii_length(s.substr(i));
+            for (size_t n = 0; n < run; n++) {
+                out[n] = static_cast<T>(static_cast<uint8_t>(s[i + n]));
+            }
+            out += run;
+            i += run;
+            if (i >= s.size()) break;
+            
+            uint8_t byte1 = static_cast<uint8_t>(s[i]);
+            
+            if ((byte1 & 0b11100000) == 0b11000000) {
+                // 2-byte UTF-8: 110xxxxx 10xxxxxx
+                if (i + 1 >= s.size()) break;
+                uint8_t byte2 = static_cast<uint8_t>(s[i + 1]);
+                
+                *out++ = static_cast<T>(((byte1 & 0b00011111) << 6) |
+                                        (byte2 & 0b00111111));
+                i += 2;
+            } else if ((byte1 & 0b11110000) == 0b11100000) {
+                // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
+                if (i + 2 >= s.size()) break;
+                uint8_t byte2 = static_cast<uint8_t>(s[i + 1]);
+                uint8_t byte3 = static_cast<uint8_t>(s[i + 2]);
+                
+                *out++ = static_cast<T>(((byte1 & 0b00001111) << 12) |
+                                        ((byte2 & 0b00111111) << 6) |
+                                        (byte3 & 0b00111111));
+                i += 3;
+            } else {
+                // Invalid or unsupported UTF-8 sequence
+                i += 1; // Skip it
+            }
+        }
+        
+        return out - start;
+    }
+    
+    /*
+     Decodes the sequence of up to four bytes starting at i, a byte that is not ASCII,
+     moving i past it. Returns false for a sequence to be dropped: a start byte that is
+     not a lead is skipped, as is the byte that breaks a sequence off, and a sequence the
+     string ends part way through is lost.
+     */
+    static bool sequence(std::string_view s, size_t &i, uint32_t &code)
+    {
+        uint8_t byte1 = static_cast<uint8_t>(s[i++]);
+        size_t needed;
+        
+        if ((byte1 & 0xE0) == 0xC0) {
+            code = byte1 & 0x1F;
+            needed = 1;
+        } else if ((byte1 & 0xF0) == 0xE0) {
+            code = byte1 & 0x0F;
+            needed = 2;
+        } else if ((byte1 & 0xF8) == 0xF0) {
+            code = byte1 & 0x07;
+            needed = 3;
+        } else {
+            return false;
+        }
+        
+        for (; needed; needed--) {
+            if (i >= s.size()) return false;
+            uint8_t c = static_cast<uint8_t>(s[i++]);
+            if ((c & 0xC0) != 0x80) return false;
+            code = (code << 6) | (c & 0x3F);
+        }
+        return true;
+    }
+    
+    // MARK: - Conversion
+    
     std::string to_string(std::u16string_view s)
     {
         return to_string(to_wstring(s));
@@ -32,7 +162,9 @@ namespace utf {
     
     std::string to_string(std::wstring_view s)
     {
-        std::string utf8;
+        // Never more than three bytes a unit, the string is sized once and trimmed after.
+        std::string utf8(s.size() * 3, '\0');
+        char *out = utf8.data();
         uint16_t utf16 = 0;
         
         for (size_t i = 0; i < s.size(); i++) {
@@ -40,25 +172,29 @@ namespace utf {
             
             if (utf16 <= 0x007F) {
                 // 1-byte UTF-8: 0xxxxxxx
-                utf8 += static_cast<char>(utf16 & 0x7F);
+                *out++ = static_cast<char>(utf16 & 0x7F);
             } else if (utf16 <= 0x07FF) {
                 // 2-byte UTF-8: 110xxxxx 10xxxxxx
-                utf8 += static_cast<char>(0b11000000 | ((utf16 >> 6) & 0b00011111));
-                utf8 += static_cast<char>(0b10000000 | (utf16 & 0b00111111));
+                *out++ = static_cast<char>(0b11000000 | ((utf16 >> 6) & 0b00011111));
+                *out++ = static_cast<char>(0b10000000 | (utf16 & 0b00111111));
             } else {
                 // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
-                utf8 += static_cast<char>(0b11100000 | ((utf16 >> 12) & 0b00001111));
-                utf8 += static_cast<char>(0b10000000 | ((utf16 >> 6) & 0b00111111));
-                utf8 += static_cast<char>(0b10000000 | (utf16 & 0b00111111));
+                *out++ = static_cast<char>(0b11100000 | ((utf16 >> 12) & 0b00001111));
+                *out++ = static_cast<char>(0b10000000 | ((utf16 >> 6) & 0b00111111));
+                *out++ = static_cast<char>(0b10000000 | (utf16 & 0b00111111));
             }
         }
         
+        utf8.resize(out - utf8.data());
         return utf8;
     }
     
     std::u16string to_u16string(std::string_view s)
     {
-        return to_u16string(to_wstring(s));
+        // Never more characters than bytes.
+        std::u16string out(s.size(), u'\0');
+        out.resize(decode(s, out.data()));
+        return out;
     }
     
     std::u16string to_u16string(std::wstring_view s)
@@ -91,42 +227,9 @@ namespace utf {
     
     std::wstring to_wstring(std::string_view s)
     {
-        std::wstring utf16;
-        size_t i = 0;
-        
-        while (i < s.size()) {
-            uint8_t byte1 = static_cast<uint8_t>(s[i]);
-            
-            if ((byte1 & 0b10000000) == 0) {
-                // 1-byte UTF-8: 0xxxxxxx
-                utf16 += static_cast<wchar_t>(byte1);
-                i += 1;
-            } else if ((byte1 & 0b11100000) == 0b11000000) {
-                // 2-byte UTF-8: 110xxxxx 10xxxxxx
-                if (i + 1 >= s.size()) break;
-                uint8_t byte2 = static_cast<uint8_t>(s[i + 1]);
-                
-                uint16_t ch = ((byte1 & 0b00011111) << 6) |
-                (byte2 & 0b00111111);
-                utf16 += static_cast<wchar_t>(ch);
-                i += 2;
-            } else if ((byte1 & 0b11110000) == 0b11100000) {
-                // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
-                if (i + 2 >= s.size()) break;
-                uint8_t byte2 = static_cast<uint8_t>(s[i + 1]);
-                uint8_t byte3 = static_cast<uint8_t>(s[i + 2]);
-                
-                uint16_t ch = ((byte1 & 0b00001111) << 12) |
-                ((byte2 & 0b00111111) << 6) |
-                (byte3 & 0b00111111);
-                utf16 += static_cast<wchar_t>(ch);
-                i += 3;
-            } else {
-                // Invalid or unsupported UTF-8 sequence
-                i += 1; // Skip it
-            }
-        }
-        
+        // Never more characters than bytes.
+        std::wstring utf16(s.size(), L'\0');
+        utf16.resize(decode(s, utf16.data()));
         return utf16;
     }
     
@@ -162,31 +265,6 @@ namespace utf {
 #endif
     }
     
-    static uint16_t convertUTF8ToUTF16(const char* s)
-    {
-        uint8_t *utf8 = (uint8_t *)s;
-        uint16_t utf16 = *utf8;
-        
-        if ((utf8[0] & 0b11110000) == 0b11100000) {
-            utf16 = utf8[0] & 0b11111;
-            utf16 <<= 6;
-            utf16 |= utf8[1] & 0b111111;
-            utf16 <<= 6;
-            utf16 |= utf8[2] & 0b111111;
-            return utf16;
-        }
-        
-        // 110xxxxx 10xxxxxx
-        if ((utf8[0] & 0b11100000) == 0b11000000) {
-            utf16 = utf8[0] & 0b11111;
-            utf16 <<= 6;
-            utf16 |= utf8[1] & 0b111111;
-            return utf16;
-        }
-        
-        return utf16;
-    }
-    
     std::string read(std::ifstream& is)
     {
         if (!is) throw std::runtime_error("Cannot open file");
@@ -336,46 +414,34 @@ namespace utf {
     {
         if (s.empty()) return 0;
         
+        std::string bytes;
+        bytes.reserve(s.size() * 2 + 2);
+        
         if (bom == BOM::le) {
-            os.put(0xFF);
-            os.put(0xFE);
+            bytes += "\xFF\xFE";
         }
         
         if (bom == BOM::be) {
-            os.put(0xFE);
-            os.put(0xFF);
+            bytes += "\xFE\xFF";
         }
         
-        std::string utf8 = to_string(s);
-        
+        // Each unit in the byte order its mark gives, carriage returns dropped.
         size_t size = 0;
-        for ( int n = 0; n < utf8.length(); n++, size += 2) {
-            uint8_t *ascii = (uint8_t *)&utf8.at(n);
-            if (utf8.at(n) == '\r') continue;
+        for (wchar_t c : s) {
+            uint16_t utf16 = static_cast<uint16_t>(c);
+            size += 2;
+            if (utf16 == '\r') continue;
             
-            // Output as UTF-16LE
-            if (*ascii >= 0x80) {
-                uint16_t utf16 = convertUTF8ToUTF16(&utf8.at(n));
-                
-#ifndef __LITTLE_ENDIAN__
-                if (bom == BOM::le) {
-                    utf16 = utf16 >> 8 | utf16 << 8;
-                }
-#else
-                if (bom == BOM::be) {
-                    utf16 = utf16 >> 8 | utf16 << 8;
-                }
-#endif
-                os.write((const char *)&utf16, 2);
-                if ((*ascii & 0b11100000) == 0b11000000) n++;
-                if ((*ascii & 0b11110000) == 0b11100000) n+=2;
-                if ((*ascii & 0b11111000) == 0b11110000) n+=3;
+            if (bom == BOM::be) {
+                bytes += static_cast<char>(utf16 >> 8);
+                bytes += static_cast<char>(utf16 & 0xFF);
             } else {
-                os.put(utf8.at(n));
-                os.put('\0');
+                bytes += static_cast<char>(utf16 & 0xFF);
+                bytes += static_cast<char>(utf16 >> 8);
             }
         }
         
+        os.write(bytes.data(), bytes.size());
         return size;
     }
     
@@ -476,9 +542,30 @@ namespace utf {
     
     size_t size(std::string_view s)
     {
-        size_t count = 0;
-        for (unsigned char c : s) {
-            if ((c & 0b1100'0000) != 0b1000'0000) {
+        size_t count = 0, i = 0;
+        
+        // Continuation bytes 10xxxxxx are those below 0xC0, -64, when signed.
+#if defined(UTF_AVX2)
+        const __m256i last = _mm256_set1_epi8(-65);
+        for (; i + 32 <= s.size(); i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.data() + i));
+            count += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(bytes, last))));
+        }
+#elif defined(UTF_SSE2)
+        const __m128i last = _mm_set1_epi8(-65);
+        for (; i + 16 <= s.size(); i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + i));
+            count += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(bytes, last))));
+        }
+#elif defined(UTF_NEON) && defined(__aarch64__)
+        for (; i + 16 <= s.size(); i += 16) {
+            int8x16_t bytes = vld1q_s8(reinterpret_cast<const int8_t *>(s.data() + i));
+            count += vaddvq_u8(vandq_u8(vcgtq_s8(bytes, vdupq_n_s8(-65)), vdupq_n_u8(1)));
+        }
+#endif
+        
+        for (; i < s.size(); i++) {
+            if ((static_cast<uint8_t>(s[i]) & 0b1100'0000) != 0b1000'0000) {
                 ++count; // start of a UTF-8 code point
             }
         }
@@ -527,5 +614,129 @@ namespace utf {
         
         return count;
     }
+    
+    // MARK: - Fast Paths
+    
+    size_t ascii_length(std::string_view s)
+    {
+        const char *data = s.data();
+        size_t length = s.size(), i = 0;
+        
+#if defined(UTF_AVX2)
+        for (; i + 32 <= length; i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+            if (high) return i + std::countr_zero(high);
+        }
+#endif
+#if defined(UTF_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+            if (high) return i + std::countr_zero(high);
+        }
+#elif defined(UTF_NEON) && defined(__aarch64__)
+        for (; i + 16 <= length; i += 16) {
+            // Which byte is left for the word at a time search below.
+            if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + i))) >= 0x80) break;
+        }
+#endif
+        
+        if constexpr (std::endian::native == std::endian::little) {
+            for (; i + 8 <= length; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                word &= 0x8080808080808080;
+                if (word) return i + std::countr_zero(word) / 8;
+            }
+        }
+        
+        while (i < length && static_cast<uint8_t>(data[i]) < 0x80) i++;
+        return i;
+    }
+    
+    bool valid(std::string_view s)
+    {
+        size_t i = 0;
+        
+        while (true) {
+            i += ascii_length(s.substr(i));
+            if (i >= s.size()) return true;
+            
+            uint8_t byte1 = static_cast<uint8_t>(s[i]);
+            size_t length;
+            uint8_t low = 0x80, high = 0xBF; // range of the second byte
+            
+            if (byte1 >= 0xC2 && byte1 <= 0xDF) {
+                length = 2;
+            } else if (byte1 >= 0xE0 && byte1 <= 0xEF) {
+                length = 3;
+                if (byte1 == 0xE0) low = 0xA0;  // overlong
+                if (byte1 == 0xED) high = 0x9F; // surrogates
+            } else if (byte1 >= 0xF0 && byte1 <= 0xF4) {
+                length = 4;
+                if (byte1 == 0xF0) low = 0x90;  // overlong
+                if (byte1 == 0xF4) high = 0x8F; // past U+10FFFF
+            } else {
+                return false;
+            }
+            
+            if (i + length > s.size()) return false;
+            
+            uint8_t byte2 = static_cast<uint8_t>(s[i + 1]);
+            if (byte2 < low || byte2 > high) return false;
+            for (size_t n = 2; n < length; n++) {
+                if ((static_cast<uint8_t>(s[i + n]) & 0b11000000) != 0b10000000) return false;
+            }
+            
+            i += length;
+        }
+    }
+    
+    size_t utf16le_size(std::string_view s)
+    {
+        size_t size = 0, i = 0;
+        uint32_t code;
+        
+        while (true) {
+            size_t run = ascii_length(s.substr(i));
+            size += run * 2;
+            i += run;
+            if (i >= s.size()) return size;
+            
+            if (sequence(s, i, code)) size += code <= 0xFFFF ? 2 : 4;
+        }
+    }
+    
+    size_t encode_utf16le(std::string_view s, char *out)
+    {
+        char *start = out;
+        size_t i = 0;
+        uint32_t code;
+        
+        while (true) {
+            size_t run = ascii_length(s.substr(i));
+            widen(s.data() + i, run, out);
+            out += run * 2;
+            i += run;
+            if (i >= s.size()) return out - start;
+            
+            if (!sequence(s, i, code)) continue;
+            
+            if (code <= 0xFFFF) {
+                *out++ = static_cast<char>(code & 0xFF);
+                *out++ = static_cast<char>(code >> 8);
+            } else {
+                // Surrogate pair
+                code -= 0x10000;
+                uint16_t high = 0xD800 + (code >> 10);
+                uint16_t low = 0xDC00 + (code & 0x3FF);
+                *out++ = static_cast<char>(high & 0xFF);
+                *out++ = static_cast<char>(high >> 8);
+                *out++ = static_cast<char>(low & 0xFF);
+                *out++ = static_cast<char>(low >> 8);
+            }
+        }
+    }
 };
 
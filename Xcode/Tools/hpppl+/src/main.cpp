@@ -38,9 +38,16 @@
 #include <string>
 #include <ranges>
 #include <unordered_set>
+#include <set>
+#include <map>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <thread>
+#include <semaphore>
 
 #include "timer.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 
 #include "directives.hpp"
 #include "dictionary.hpp"
@@ -57,22 +64,49 @@
 #include "extensions.hpp"
 #include "tool.hpp"
 #include "pascal.hpp"
+#include "lexer.hpp"
+#include "patterns.hpp"
+#include "translation_cache.hpp"
+#include "archive.hpp"
+#include "profiler.hpp"
+#include "json.hpp"
+#include "watcher.hpp"
+#include "project.hpp"
+#include "work_pool.hpp"
+#include "build_record.hpp"
+#include "source_buffer.hpp"
+#include "output_stream.hpp"
 
 #include "../version_code.h"
 
 #define NAME "HP PPL+ Pre-Processor for HP PPL"
 #define COMMAND_NAME "hpppl+"
-#define INDENT_WIDTH indentation
 
-static unsigned int indentation = 2;
-
-using hppplplus::Singleton;
+using hppplplus::TranslationContext;
 using hppplplus::Aliases;
 using hppplplus::Alias;
 using hppplplus::Calc;
 using hppplplus::Dictionary;
 using hppplplus::Directives;
 using hppplplus::Base;
+using hppplplus::Lexer;
+using hppplplus::Patterns;
+using hppplplus::TranslationCache;
+using hppplplus::ArchiveWriter;
+using hppplplus::ArchiveReader;
+using hppplplus::IncludeTable;
+using hppplplus::Profiler;
+using hppplplus::Watcher;
+using hppplplus::Project;
+using hppplplus::WorkPool;
+using hppplplus::BuildRecord;
+using hppplplus::LineReader;
+using hppplplus::OutputStream;
+using hppplplus::StringOutput;
+using hppplplus::PostPasses;
+using hppplplus::FileOutput;
+
+typedef Profiler::Stage Stage;
 
 using std::regex_replace;
 using std::sregex_iterator;
@@ -81,32 +115,108 @@ using std::sregex_token_iterator;
 namespace fs = std::filesystem;
 namespace rc = std::regex_constants;
 
-static Directives directives = Directives();
+typedef TranslationContext::TAddon addon_t;
 
-typedef struct {
-    std::string command;
-    std::string extension;
-    std::vector<std::string> arguments; // Unused
-} addon_t;
+static TranslationCache cache = TranslationCache();
 
-static std::vector<addon_t> addons = {};
+// Add-on conversions run at once across every file being built, as many as `-j` builds files.
+static size_t addonJobs = std::max(1u, std::thread::hardware_concurrency());
 
-std::string include(const std::filesystem::path& path);
+std::string include(TranslationContext &context, const std::filesystem::path& path);
 
 // MARK: - Other
 
 void terminator() {
-    std::cerr << MessageType::CriticalError << "An internal pre-processing problem occurred at line:" << Singleton::shared()->currentLineNumber() << "\nPlease review the syntax before this point.\n";
+    TranslationContext *context = TranslationContext::current();
+    std::cerr << MessageType::CriticalError << "An internal pre-processing problem occurred at line:" << (context ? context->currentLineNumber() : 0) << "\nPlease review the syntax before this point.\n";
     exit(1);
 }
 void (*old_terminate)() = std::set_terminate(terminator);
 
-std::string translatePPLPlusToPPL(const fs::path& path);
+std::string translatePPLPlusToPPL(TranslationContext &context, const fs::path& path);
+std::string translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, std::string_view code);
+void translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, OutputStream &stream);
+void translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, std::string_view code, OutputStream &stream);
 
 // MARK: - PPL+ To PPL Translater...
 
-std::string translatePPLPlusLine(const std::string& input) {
-    std::regex re;
+static const std::unordered_set<std::string> functions = {
+    "log", "cos", "sin", "tan", "ln", "min", "max"
+};
+
+static const std::unordered_set<std::string> keywords = {
+    "end", "return", "kill", "if", "then", "else", "xor", "or", "and", "not",
+    "case", "default", "iferr", "ifte", "for", "from", "step", "downto", "to", "do",
+    "while", "repeat", "until", "break", "continue", "const", "local",
+    "eval", "freeze", "view", "begin", "export"
+};
+
+/*
+ Appends the translation of a single word, `var` becomes `LOCAL` and the math
+ functions are capitalized. When `keywordsToo` is set, a `begin` inside a scope
+ is removed and the keywords are capitalized.
+ */
+static void rewriteWord(std::string_view word, std::string &out, const bool removeBegin, const bool keywordsToo) {
+    // No keyword or function is longer than 8 letters, leave any longer word as is.
+    if (word.length() > 8) {
+        out.append(word);
+        return;
+    }
+    
+    std::string lowercase(word);
+    for (auto &c : lowercase) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    
+    if (lowercase == "var") {
+        out.append("LOCAL");
+        return;
+    }
+    
+    if (keywordsToo && removeBegin && lowercase == "begin") return;
+    
+    if (functions.count(lowercase) || (keywordsToo && keywords.count(lowercase))) {
+        for (auto c : lowercase) out.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+        return;
+    }
+    
+    out.append(word);
+}
+
+/*
+ Counts the scopes opened and closed by the keywords in the line, opening every
+ scope before closing any, as a line such as `IF A THEN B END;` must leave the
+ depth where it started.
+ */
+static void countScopes(TranslationContext &context, const std::string &str) {
+    static const std::unordered_set<std::string_view> opens = {
+        "BEGIN", "IF", "FOR", "CASE", "REPEAT", "WHILE", "IFERR"
+    };
+    static const std::unordered_set<std::string_view> closes = {
+        "END", "UNTIL"
+    };
+    
+    auto isWordCharacter = [](const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    };
+    
+    int opened = 0, closed = 0;
+    std::string_view s(str);
+    for (size_t i = 0; i < s.length(); ) {
+        if (!isWordCharacter(s[i])) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < s.length() && isWordCharacter(s[i])) ++i;
+        auto word = s.substr(start, i - start);
+        if (opens.count(word)) opened++;
+        else if (closes.count(word)) closed++;
+    }
+    
+    while (opened--) context.increaseScopeDepth();
+    while (closed--) context.decreaseScopeDepth();
+}
+
+std::string translatePPLPlusLine(TranslationContext &context, const std::string& input) {
     std::smatch match;
     std::ifstream infile;
     std::string output = input;
@@ -117,81 +227,117 @@ std::string translatePPLPlusLine(const std::string& input) {
         return output;
     }
     
-    output = directives.parse(output);
+    {
+        Profiler::Scope scope(Stage::Directives);
+        output = context.directives.parse(output);
+    }
 
     /*
      While parsing the contents, strings may inadvertently undergo parsing, leading
      to potential disruptions in the string's content as well as comments.
      
-     To address this issue, we prioritize the preservation of any existing strings
-     and comments. After we prioritize the preservation of any existing strings and
-     comments, we blank out the string/s.
+     To address this issue, the line is lexed once, separating the code from any
+     strings and comment, with the strings in the code blanked out as `""`.
      
      Subsequently, after parsing, any strings that have been blanked out can be
      restored to their original state.
      */
-    auto strings = preserveStrings(output);
-    output = blankOutStrings(output);
- 
-    std::string comment = extractComment(output);
-    output = removeComment(output);
+    Lexer::TLine line;
+    {
+        Profiler::Scope scope(Stage::Lexing);
+        line = Lexer::split(output);
+    }
+    auto& strings = line.strings;
+    std::string& comment = line.comment;
+    output = std::move(line.code);
     
     // Resolve all regular expressions
-    Singleton::shared()->regexp.applyAllRegularExpressions(output);
-    output = processEscapes(output);
-    
-    output = replaceOperators(output);
-    output = fixUnaryMinus(output);
-    
-    output = Singleton::shared()->aliases.resolveAllAliasesInText(output);
+    {
+        Profiler::Scope scope(Stage::RegexRules);
+        context.regexp.applyAllRegularExpressions(output);
+    }
+    {
+        Profiler::Scope scope(Stage::Escapes);
+        output = processEscapes(output);
+    }
+    {
+        Profiler::Scope scope(Stage::Operators);
+        output = replaceOperators(output);
+    }
+    {
+        Profiler::Scope scope(Stage::UnaryMinus);
+        output = fixUnaryMinus(output);
+    }
+    {
+        Profiler::Scope scope(Stage::Aliases);
+        output = context.aliases.resolveAllAliasesInText(output);
+    }
    
     /*
      A code stack provides a convenient way to store code snippets
      that can be retrieved and used later.
      */
-    output = Singleton::shared()->codeStack.parse(output);
+    {
+        Profiler::Scope scope(Stage::CodeStack);
+        output = context.codeStack.parse(output);
+    }
 
-    if (Dictionary::isDictionaryDefinition(output)) {
-        Dictionary::proccessDictionaryDefinition(output);
-        output = Dictionary::removeDictionaryDefinition(output);
-        if (output.empty())
-            return "";
+    {
+        Profiler::Scope scope(Stage::Dictionary);
+        if (Dictionary::isDictionaryDefinition(output)) {
+            Dictionary::proccessDictionaryDefinition(output, context);
+            output = Dictionary::removeDictionaryDefinition(output);
+            if (output.empty())
+                return "";
+        }
     }
 
-    output = replaceWords(output, {"var"}, "LOCAL");
-    output = regex_replace(output, std::regex(R"(\bloop\b)", std::regex_constants::icase), "WHILE 1 DO");
-    output = capitalizeWords(output, {"log", "cos", "sin", "tan", "ln", "min", "max"});
-    
-    //MARK: User Define Alias Parsing
-    output = Alias::parse(output);
-    
-    if (Singleton::shared()->scopeDepth > 0) {
-        output = replaceWords(output, {"begin"}, "");
+    if (containsIgnoringCase(output, "loop")) {
+        Profiler::Scope scope(Stage::Loop);
+        output = regex_replace(output, Patterns::shared().loop, "WHILE 1 DO");
     }
-    // Keywords
-    output = capitalizeWords(output, {
-        "end", "return", "kill", "if", "then", "else", "xor", "or", "and", "not",
-        "case", "default", "iferr", "ifte", "for", "from", "step", "downto", "to", "do",
-        "while", "repeat", "until", "break", "continue", "const", "local",
-        "eval", "freeze", "view", "begin", "export", "const", "local"
-    });
     
-    re = R"(\b(BEGIN|IF|FOR|CASE|REPEAT|WHILE|IFERR)\b)";
-    for(auto it = sregex_iterator(output.begin(), output.end(), re); it != sregex_iterator(); ++it) {
-        Singleton::shared()->increaseScopeDepth();
+    /*
+     The word substitutions are made in a single pass over the words of the line. Only
+     when the line defines an alias are they split either side of the alias parsing, as
+     an alias definition must see `var` and the math functions already substituted but
+     not the keywords.
+     */
+    bool removeBegin = context.scopeDepth > 0;
+    if (containsIgnoringCase(output, "alias")) {
+        {
+            Profiler::Scope scope(Stage::Keywords);
+            output = Lexer::rewriteWords(output, [](std::string_view word, std::string &out) {
+                rewriteWord(word, out, false, false);
+            });
+        }
+        
+        //MARK: User Define Alias Parsing
+        {
+            Profiler::Scope scope(Stage::AliasDefinitions);
+            output = Alias::parse(output, context);
+        }
+        
+        Profiler::Scope scope(Stage::Keywords);
+        output = Lexer::rewriteWords(output, [removeBegin](std::string_view word, std::string &out) {
+            rewriteWord(word, out, removeBegin, true);
+        });
+    } else {
+        Profiler::Scope scope(Stage::Keywords);
+        output = Lexer::rewriteWords(output, [removeBegin](std::string_view word, std::string &out) {
+            rewriteWord(word, out, removeBegin, true);
+        });
     }
     
-    re = R"(\b(END|UNTIL)\b)";
-    for(auto it = sregex_iterator(output.begin(), output.end(), re); it != sregex_iterator(); ++it) {
-        Singleton::shared()->decreaseScopeDepth();
-        Singleton::shared()->aliases.removeAllOutOfScopeAliases();
-        Singleton::shared()->regexp.removeAllOutOfScopeRegexps();
+    {
+        Profiler::Scope scope(Stage::Scopes);
+        countScopes(context, output);
     }
     
-    if (Singleton::shared()->scopeDepth == 0) {
-        re = R"(^ *(KS?A?_[A-Z\d][a-z]*) *$)";
+    if (context.scopeDepth == 0 && output.find('_') != std::string::npos) {
+        Profiler::Scope scope(Stage::Key);
         sregex_token_iterator it = sregex_token_iterator {
-            output.begin(), output.end(), re, {1}
+            output.begin(), output.end(), Patterns::shared().key, {1}
         };
         if (it != sregex_token_iterator()) {
             std::string s = *it;
@@ -199,30 +345,35 @@ std::string translatePPLPlusLine(const std::string& input) {
         }
     }
     
-    output = Calc::parse(output);
-    output = Base::parse(output);
+    {
+        Profiler::Scope scope(Stage::Calc);
+        output = Calc::parse(output);
+    }
+    {
+        Profiler::Scope scope(Stage::Base);
+        output = Base::parse(output);
+    }
     
     // Include
     if (Directives::isIncludeDirective(output)) {
-        Singleton& singleton = *Singleton::shared();
-        auto path = singleton.currentSourceFilePath();
+        Profiler::Scope scope(Stage::Include);
+        auto path = context.currentSourceFilePath();
         std::filesystem::path includePath = Directives::extractIncludeDirective(input);
-        static const std::regex re(
-                                   R"(\{\$(?:INCLUDE|I) +[\w \-_~,;\[\]\(\).']+ *\})",
-                                   std::regex_constants::icase
-                                   );
         std::string ext = std::lowercased(includePath.extension().string());
         if (ext != ".hppplplus" || ext != ".hpppl+") {
-            if (includePath.parent_path().empty() && !fs::exists(includePath))
+            if (includePath.parent_path().empty() && !context.includes.exists(includePath))
                 includePath = path.parent_path() / includePath;
         }
         
-        auto content = include(includePath);
-        output = std::regex_replace(output, re, content);
+        auto content = include(context, includePath);
+        output = std::regex_replace(output, Patterns::shared().include, content);
     }
     
     
-    output = restoreStrings(output, strings);
+    {
+        Profiler::Scope scope(Stage::RestoreStrings);
+        output = restoreStrings(output, strings);
+    }
     
     if (!comment.empty()) output += comment;
 
@@ -232,7 +383,7 @@ std::string translatePPLPlusLine(const std::string& input) {
 }
 
 
-void loadRegexLib(const fs::path path, const bool verbose) {
+void loadRegexLib(TranslationContext &context, const fs::path path, const bool verbose) {
     std::string utf8;
     std::ifstream infile;
     
@@ -240,79 +391,296 @@ void loadRegexLib(const fs::path path, const bool verbose) {
     if (!infile.is_open()) {
         return;
     }
+    context.dependsOn(path);
     
-    if (verbose) std::cerr << "Library " << (path.filename() == ".base.re" ? "base" : path.stem()) << " successfully loaded.\n";
+    if (verbose) diagnostics() << "Library " << (path.filename() == ".base.re" ? "base" : path.stem()) << " successfully loaded.\n";
     
+    // Rules take their location from the library, so they can be traced back to it.
+    context.pushPath(path);
     while (getline(infile, utf8)) {
         utf8.insert(0, "regex ");
-        Singleton::shared()->regexp.parse(utf8);
+        context.regexp.parse(utf8);
+        context.incrementLineNumber();
     }
+    context.popPath();
     
     infile.close();
 }
 
-void loadRegexLibs(const std::filesystem::path& path, const bool verbose) {
+void loadRegexLibs(TranslationContext &context, const std::filesystem::path& path, const bool verbose) {
     if (path.empty()) return;
-    loadRegexLib(path / "base.re", verbose);
+    loadRegexLib(context, path / "base.re", verbose);
     
     try {
         for (const auto& entry : fs::directory_iterator(path)) {
             if (fs::path(entry.path()).extension() != ".re" || fs::path(entry.path()).filename() == "base.re") {
                 continue;
             }
-            loadRegexLib(entry.path(), verbose);
+            loadRegexLib(context, entry.path(), verbose);
         }
     } catch (const fs::filesystem_error& e) {
-        std::cerr << "error: " << e.what() << '\n';
+        diagnostics() << "error: " << e.what() << '\n';
+    }
+}
+
+// MARK: - Translation State
+
+static std::string translationState(const TranslationContext &context, const bool locations) {
+    ArchiveWriter archive;
+    context.save(archive, locations);
+    return archive.data();
+}
+
+static bool restoreTranslationState(TranslationContext &context, const std::string &state) {
+    ArchiveReader archive(state);
+    return context.load(archive);
+}
+
+// Restores the state ahead of another build, forgetting every file read and any errors reported.
+static void resetTranslationState(TranslationContext &context, const std::string &state) {
+    context.unwind();
+    context.includes.reset();
+    restoreTranslationState(context, state);
+    context.directives.disregard = false;
+    context.failed = false;
+}
+
+/*
+ Translates a file included by another, reusing its translation from the cache when
+ the file, each file its translation read and the incoming translation state are all
+ unchanged. Translations that reported anything are never cached, so their messages
+ are seen on every build.
+ */
+static std::string translateIncludedFile(TranslationContext &context, const fs::path& path) {
+    if (!cache.enabled) return translatePPLPlusToPPL(context, path);
+    
+    auto key = cache.key(path, context.includes.digest(path), translationState(context, false));
+    if (auto entry = cache.lookup(key)) {
+        if (restoreTranslationState(context, entry->state)) {
+            context.dependsOn(entry->dependencies);
+            return entry->output;
+        }
+    }
+    
+    size_t messages = context.messages;
+    context.beginRecording();
+    std::string output = translatePPLPlusToPPL(context, path);
+    
+    TranslationCache::TEntry entry = {
+        .output = output,
+        .state = translationState(context, true),
+        .dependencies = context.endRecording()
+    };
+    if (context.messages == messages) cache.store(key, entry);
+    
+    return output;
+}
+
+// The add-on binary as it is installed, so that replacing it is never mistaken for the one that ran before.
+static std::string addonIdentity(const std::string &command) {
+    fs::path path = tool::pluginPath(command);
+    std::error_code ec;
+    
+    if (!fs::exists(path, ec)) path = fs::path(tool::executableDir()) / command;
+    
+    auto size = fs::file_size(path, ec);
+    if (ec) return "-";
+    auto time = fs::last_write_time(path, ec);
+    if (ec) return "-";
+    
+    return path.string() + '\n' + std::to_string(size) + '\n' + std::to_string(time.time_since_epoch().count());
+}
+
+/*
+ Converts a file with an add-on, in-process when built as a shared library, otherwise by
+ running it. Each conversion takes one of addonJobs slots shared by the whole process,
+ whichever file and thread it is for.
+ */
+static tool::result_t convert(const addon_t &addon, const fs::path &path) {
+    static std::counting_semaphore<> slots(static_cast<std::ptrdiff_t>(addonJobs));
+    
+    slots.acquire();
+    struct Release {
+        ~Release() { slots.release(); }
+    } release;
+    
+    if (auto result = tool::runPlugin(addon.command, path.string(), addon.arguments)) return *result;
+    
+    std::vector<std::string> arguments = {path.string(), "-o", "/dev/stdout"};
+    arguments.insert(arguments.end(), addon.arguments.begin(), addon.arguments.end());
+    return tool::runTool(addon.command, arguments);
+}
+
+/*
+ Runs an add-on on an included file. Its output is kept on disk in the translation
+ cache, keyed by the add-on binary, its arguments and the content of the file, and in
+ memory for as long as the process runs, so an add-on only runs again once either has
+ changed. A conversion that failed is forgotten, so the next build tries it again.
+ 
+ A conversion already under way, such as one started by prefetchAddons, is waited on
+ rather than started again.
+ */
+static std::string runAddon(const addon_t &addon, const fs::path &path) {
+    static std::unordered_map<std::string, std::shared_future<std::string>> outputs;
+    static std::mutex mutex;
+    
+    ArchiveWriter archive;
+    archive.write("add-on");
+    archive.write(addonIdentity(addon.command));
+    archive.write(IncludeTable::canonical(path).string());
+    for (const auto &argument : addon.arguments) archive.write(argument);
+    archive.write(TranslationCache::fileDigest(path));
+    auto key = TranslationCache::digest(archive.data());
+    
+    std::promise<std::string> promise;
+    std::shared_future<std::string> output;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [it, inserted] = outputs.try_emplace(key, promise.get_future().share());
+        if (!inserted) {
+            output = it->second;
+        }
+    }
+    if (output.valid()) return output.get();
+    
+    if (auto entry = cache.lookup(key)) {
+        promise.set_value(entry->output);
+        return entry->output;
+    }
+    
+    auto result = convert(addon, path);
+    if (result.exitCode == 0) {
+        cache.store(key, {.output = result.out});
+    } else {
+        result.out.clear();
+        
+        // Those already waiting on it still see it fail, those that come later run it again.
+        std::lock_guard<std::mutex> lock(mutex);
+        outputs.erase(key);
+    }
+    promise.set_value(result.out);
+    return result.out;
+}
+
+/*
+ Starts converting, in the background, every file `code` includes that an add-on
+ converts, so the conversions run at the same time as each other and as translation,
+ rather than one after another as translation reaches each include. The add-ons are
+ those already declared and those `code` declares. The returned future is waited on
+ as it is destroyed.
+ 
+ Whether a conditional region is translated is only known once translation reaches
+ it, so nothing between an {$IFDEF} or {$IFNDEF} and its {$ENDIF} is prefetched; it
+ is converted, if at all, when translation includes it.
+ */
+static std::future<void> prefetchAddons(TranslationContext &context, const fs::path &path, std::string_view code) {
+    const Patterns &patterns = Patterns::shared();
+    std::vector<addon_t> addons = context.addons;
+    std::vector<std::pair<addon_t, fs::path>> conversions;
+    std::smatch match;
+    
+    if (code.find("{$") == std::string_view::npos) return {};
+    
+    LineReader lines(code);
+    std::string_view view;
+    std::string line;
+    int depth = 0;
+    while (lines.next(view)) {
+        if (view.find("{$") == std::string_view::npos) continue;
+        line.assign(view);
+        
+        if (std::regex_search(line, patterns.ifdef) || std::regex_search(line, patterns.ifndef)) {
+            depth++;
+            continue;
+        }
+        if (std::regex_search(line, patterns.endifDirective)) {
+            if (depth > 0) depth--;
+            continue;
+        }
+        if (depth > 0) continue;
+        
+        if (std::regex_search(line, match, patterns.addon)) {
+            addons.push_back({
+                .command = match.str(1),
+                .extension = match.str(2)
+            });
+            continue;
+        }
+        
+        if (!std::regex_search(line, match, patterns.includePath)) continue;
+        
+        // Resolved as translation resolves it, so both find the same conversion.
+        fs::path includePath = match.str(1);
+        if (includePath.parent_path().empty() && !context.includes.exists(includePath))
+            includePath = path.parent_path() / includePath;
+        
+        auto ext = std::lowercased(includePath.extension().string());
+        auto addon = std::find_if(addons.begin(), addons.end(), [&](const addon_t &addon) { return addon.extension == ext; });
+        if (addon == addons.end() || !fs::exists(includePath)) continue;
+        
+        conversions.emplace_back(*addon, includePath);
     }
+    
+    if (conversions.empty()) return {};
+    
+    return std::async(std::launch::async, [conversions = std::move(conversions)] {
+        WorkPool(std::min(addonJobs, conversions.size())).run(conversions.size(), [&](const size_t i) {
+            runAddon(conversions[i].first, conversions[i].second);
+        });
+    });
 }
 
-std::string include(const std::filesystem::path& path) {
+std::string include(TranslationContext &context, const std::filesystem::path& path) {
     std::string output;
     auto ext = std::lowercased(path.extension().string());
     
-    if (!fs::exists(path)) {
-        std::cerr << MessageType::Verbose << path.filename() << " file not found\n";
+    IncludeTable &includes = context.includes;
+    
+    context.dependsOn(path);
+    
+    if (!includes.exists(path)) {
+        diagnostics() << MessageType::Verbose << path.filename() << " file not found\n";
         return output;
     }
     
+    if (!includes.enter(path)) {
+        return output;
+    }
+    
+    // A translation may rightly be empty, as that of a file holding only definitions is.
+    bool translated = false;
+    
     if (ext == ".hppplplus" || ext == ".hpppl+") {
-        output = translatePPLPlusToPPL(path);
+        output = translateIncludedFile(context, path);
+        translated = true;
     }
     
     if (ext == ".hpppl") {
-        output = utf::load(path);
+        output = includes.load(path);
     }
     
-    if (!addons.empty()) {
-        for (const addon_t &addon : addons) {
+    if (!context.addons.empty()) {
+        for (const addon_t &addon : context.addons) {
             if (ext != addon.extension) continue;
-            std::vector<std::string> arguments = {path.string(), "-o", "/dev/stdout"};
-            arguments.insert(arguments.end(), addon.arguments.begin(), addon.arguments.end());
-            auto result = tool::runTool(addon.command, arguments);
-            if (result.exitCode == 0) {
-                output = result.out;
+            output = runAddon(addon, path);
+            translated = true;
+            if (output.empty()) {
+                diagnostics() << MessageType::Warning << path.filename() << " could not be converted by the " << addon.command << " add-on\n";
             }
             break;
         }
     }
     
-    if (output.empty()) {
-        utf::BOM bom = utf::bom(path);
-        if (bom == utf::BOM::none) {
-            output = utf::load(path);
-        } else {
-            auto utf16 = utf::load(path, bom);
-            output = utf::to_string(utf16);
-        }
+    if (output.empty() && !translated) {
+        output = includes.decode(path);
     }
     
     return output;
 }
 
-bool verbose(void) {
-    if (Singleton::shared()->aliases.verbose) return true;
-    if (directives.verbose) return true;
+bool verbose(const TranslationContext &context) {
+    if (context.aliases.verbose) return true;
+    if (context.directives.verbose) return true;
     
     return false;
 }
@@ -330,34 +698,34 @@ bool isPPLBlock(const std::string& str) {
     return str.find("#PPL") != std::string::npos;
 }
 
-std::string processPPLBlock(std::istringstream& iss) {
-    std::string str;
+std::string processPPLBlock(TranslationContext &context, LineReader& lines) {
+    std::string_view str;
     std::string output;
     
-    Singleton::shared()->incrementLineNumber();
+    context.incrementLineNumber();
     
-    while(getline(iss, str)) {
-        if (str.find("#END") != std::string::npos) {
-            Singleton::shared()->incrementLineNumber();
+    while(lines.next(str)) {
+        if (str.find("#END") != std::string_view::npos) {
+            context.incrementLineNumber();
             return output;
         }
         
-        output += str + '\n';
-        Singleton::shared()->incrementLineNumber();
+        output.append(str).append(1, '\n');
+        context.incrementLineNumber();
     }
-    return str;
+    return "";
 }
 
-std::string processPythonBlock(std::istringstream& iss, const std::string& input) {
-    std::regex re;
+std::string processPythonBlock(TranslationContext &context, LineReader& lines, const std::string& input) {
     std::string str;
+    std::string_view line;
     std::string output;
     std::smatch match;
     
-    Aliases aliases;
-    aliases.verbose = Singleton::shared()->aliases.verbose;
+    Aliases aliases(context);
+    aliases.verbose = context.aliases.verbose;
     
-    Singleton::shared()->incrementLineNumber();
+    context.incrementLineNumber();
     
     str = cleanWhitespace(input);
 
@@ -390,19 +758,19 @@ std::string processPythonBlock(std::istringstream& iss, const std::string& input
         output = "#PYTHON\n";
     }
 
-    while(getline(iss, str)) {
+    while(lines.next(line)) {
+        str.assign(line);
         if (str.find("#END") != std::string::npos) {
             output += "#END\n";
-            Singleton::shared()->incrementLineNumber();
+            context.incrementLineNumber();
             return output;
         }
         
-        Singleton::shared()->incrementLineNumber();
+        context.incrementLineNumber();
         str = aliases.resolveAllAliasesInText(str);
         
         // alias aliasname as realname
-        re = R"(^ *alias +([A-Za-z_]\w*) *as *([a-zA-Z][\w\[\]]*) *$)";
-        if (regex_search(str, match, re)) {
+        if (regex_search(str, match, Patterns::shared().pythonAlias)) {
             Aliases::TIdentity identity;
             identity.identifier = match[1].str();
             identity.real = match[2].str();
@@ -426,19 +794,71 @@ static bool is_all_whitespace(const std::string& s) {
     return trimmed.begin() == trimmed.end();
 }
 
-std::string translatePPLPlusToPPL(const fs::path& path) {
-    Singleton& singleton = *Singleton::shared();
-    std::istringstream hppplplus;
-    std::regex re;
+// Translated PPL is passed on in chunks of about this size, at the end of a line.
+static const size_t outputChunkSize = 64 * 1024;
+
+std::string translatePPLPlusToPPL(TranslationContext &context, const fs::path& path) {
+    StringOutput output;
+    translatePPLPlusToPPL(context, path, output);
+    return std::move(output.text());
+}
+
+std::string translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, std::string_view code) {
+    StringOutput output;
+    translatePPLPlusToPPL(context, path, code, output);
+    return std::move(output.text());
+}
+
+void translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, OutputStream &stream) {
+    std::string_view code;
+    {
+        Profiler::Scope scope(Stage::Loading);
+        code = context.includes.load(path);
+    }
+    translatePPLPlusToPPL(context, path, code, stream);
+}
+
+/*
+ Translates code as if read from the file at path, which any relative includes are
+ resolved against, writing the PPL to stream as it is translated and closing it once done.
+ */
+void translatePPLPlusToPPL(TranslationContext &context, const fs::path& path, std::string_view code, OutputStream &stream) {
+    const Patterns &patterns = Patterns::shared();
+    LineReader hppplplus(code);
+    std::string_view line;
     std::string input;
     std::string output;
-    std::string code;
+    PostPasses passes(stream);
 
-    singleton.pushPath(path);
-    code = utf::load(path);
+    context.pushPath(path);
+    
+    auto conversions = prefetchAddons(context, path, code);
     
-    hppplplus.str(code);
-    while (getline(hppplplus, input)) {
+    while (true) {
+        if (output.length() >= outputChunkSize) {
+            passes.write(output);
+            output.clear();
+        }
+        
+        if (context.directives.disregard == true) {
+            /*
+             Rather than reading each line of a disabled region, skip straight past the
+             directive that ends it.
+             */
+            long lines = 0;
+            hppplplus.seek(context.directives.skip(code, hppplplus.position(), lines));
+            while (lines--) context.incrementLineNumber();
+            
+            if (context.directives.disregard == true) {
+                diagnostics() << MessageType::Error << "missing {$ENDIF}\n";
+                context.directives.disregard = false;
+            }
+        }
+        
+        // Each line is only copied out of the source to be translated, reusing the same string.
+        if (!hppplplus.next(line)) break;
+        input.assign(line);
+        
         /*
          Handle any escape lines `\` by continuing to read line joining them all up as one long line.
          */
@@ -446,50 +866,42 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
         if (!input.empty()) {
             while (input.at(input.length() - 1) == '\\' && !input.empty()) {
                 input.resize(input.length() - 1);
-                std::string s;
-                getline(hppplplus, s);
+                std::string_view s;
+                if (!hppplplus.next(s)) s = {};
                 input.append(s);
-                Singleton::shared()->incrementLineNumber();
+                context.incrementLineNumber();
                 if (s.empty()) break;
             }
         } else {
-            Singleton::shared()->incrementLineNumber();
+            context.incrementLineNumber();
             output += "\n";
             continue;
         }
         
         input = removeTripleSlashComment(input);
         
-        input = regex_replace(input, std::regex(R"(\t)"), std::string(INDENT_WIDTH, ' '));
+        for (size_t pos = input.find('\t'); pos != std::string::npos; pos = input.find('\t', pos + context.indentation)) {
+            input.replace(pos, 1, context.indentation, ' ');
+        }
         
         if (input.find("#EXIT") != std::string::npos) {
             break;
         }
         
-        while (directives.disregard == true) {
-            input = directives.parse(input);
-            Singleton::shared()->incrementLineNumber();
-            getline(hppplplus, input);
-        }
-        
         if (isPythonBlock(input)) {
-            output += processPythonBlock(hppplplus, input);
+            output += processPythonBlock(context, hppplplus, input);
             continue;
         }
         
         if (isPPLBlock(input)) {
-            output += processPPLBlock(hppplplus);
+            output += processPPLBlock(context, hppplplus);
             continue;
         }
         
         // Addons
         std::smatch match;
-        re = std::regex(
-            R"(^ *\{\$ADDON +([\w \-_~,;\[\]\(\).']+)(\.[a-z0-9]{1,10}) *\} *$)",
-            std::regex_constants::icase
-        );
-        if (std::regex_search(input, match, re)) {
-            addons.push_back({
+        if (std::regex_search(input, match, patterns.addon)) {
+            context.addons.push_back({
                 .command = match.str(1),
                 .extension = match.str(2)
             });
@@ -497,35 +909,30 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
         }
         
         // Unit
-        re = std::regex(
-            R"(^ *unit +([\w \-_~,;\[\]\(\).']+) *$)",
-            std::regex_constants::icase
-        );
-        if (std::regex_search(input, match, re)) {
+        if (std::regex_search(input, match, patterns.unit)) {
             fs::path file = match.str(1);
-            for (const auto& path : directives.systemIncludePath) {
-                if (file.parent_path().empty())
-                    file = path / file;
-                if (file.has_extension() == false) {
-                    file.replace_extension("hpppl+");
-                }
-                if (fs::exists(file)) {
-                    output += translatePPLPlusToPPL(file);
-                    continue;
+            if (file.has_extension() == false) {
+                file.replace_extension("hpppl+");
+            }
+            
+            auto resolved = context.includes.resolve(file, context.directives.systemIncludePath);
+            if (resolved) {
+                context.dependsOn(*resolved);
+                if (context.includes.enter(*resolved)) {
+                    output += translateIncludedFile(context, *resolved);
                 }
             }
-              
+            
             continue;
         }
         
         // Handle `#pragma mode` for PPL+
         if (input.find("#pragma mode") != std::string::npos) {
-            re = R"(([a-zA-Z]\w*)\(([^()]*)\))";
             std::string s = input;
             input = "";
-            for(auto it = sregex_iterator(s.begin(), s.end(), re); it != sregex_iterator(); ++it) {
+            for(auto it = sregex_iterator(s.begin(), s.end(), patterns.pragmaFunction); it != sregex_iterator(); ++it) {
                 if (it->str(1) == "indentation") {
-                    indentation = atoi(it->str(2).c_str());
+                    context.indentation = atoi(it->str(2).c_str());
                     continue;
                 }
                 
@@ -537,13 +944,12 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
             if (input.size()) {
                 output += "#pragma mode( " + input + ")\n";
             }
-            Singleton::shared()->incrementLineNumber();
+            context.incrementLineNumber();
             continue;
         }
         
-        if (Singleton::shared()->regexp.parse(input)) {
-            input = regex_replace(input, std::regex(R"(^ *\bregex +([@<>=≠≤≥~])?`([^`]*)`(i)? *(.*)$)"), "");
-            Singleton::shared()->incrementLineNumber();
+        if (context.regexp.parse(input)) {
+            context.incrementLineNumber();
             continue;
         }
        
@@ -553,25 +959,20 @@ std::string translatePPLPlusToPPL(const fs::path& path) {
         
 
         while(getline(iss, str)) {
-            std::string s = translatePPLPlusLine(str);
+            std::string s = translatePPLPlusLine(context, str);
             if (is_all_whitespace(s)) {
                 continue;
             }
             output += s;
         }
         
-        Singleton::shared()->incrementLineNumber();
+        context.incrementLineNumber();
     }
     
-    singleton.popPath();
-    
-    // Removes `uses`
-    output = regex_replace(output, std::regex(R"(\buses\s+([^;]+);)", std::regex_constants::icase), "\n");
-    
-    // Collapse multiple consecutive blank lines into a single blank line.
-    output = regex_replace(output, std::regex(R"(\n{3,})"), "\n\n");
+    context.popPath();
     
-    return output;
+    passes.write(output);
+    passes.close();
 }
 
 
@@ -597,11 +998,26 @@ void help(void) {
     << "  -n or --named           Create the .hpprgm as a named program.\n"
     << "  --indent                Set the indentation width for reformatting."
     << "  -v or --verbose         Display detailed processing information.\n"
+    << "  --no-cache              Translate every included file, ignoring the translation cache.\n"
+    << "                          The cache is kept in $XDG_CACHE_HOME/hpppl+, or ~/.cache/hpppl+.\n"
+    << "  --profile               Report the time spent in each stage of pre-processing.\n"
+    << "  --profile-json <file>   Write the time spent in each stage of pre-processing as JSON.\n"
+    << "  --profile-regex         Report the regular expressions taking the most time, and those never matched.\n"
+    << "  --include-once          Include each file only once, as if every file began with {$ONCE}.\n"
+    << "  --server                Build each JSON request read from stdin, answering each on stdout.\n"
+    << "  --watch                 Build again whenever the input file, or any file it includes, changes.\n"
+    << "  -j <jobs>               Build up to <jobs> input files at once, given more than one.\n"
+    << "  --batch <file>          Build each of the input files listed in <file>, one per line.\n"
+    << "  --project <file>        Build the program and note of an .xprimeproj project, skipping those up to date.\n"
+    << "  -MD                     Write the files read building the output as a Makefile rule, to the output with a .d extension.\n"
+    << "  -MF <file>              Write the Makefile rule to <file>.\n"
+    << "  -MP                     Add a rule without prerequisites for each file read, as GCC does.\n"
     << "\n"
     << "Additional Commands:\n"
-    << "  " << COMMAND_NAME << " {--version | --help }\n"
+    << "  " << COMMAND_NAME << " {--version | --help | --clear-cache }\n"
     << "    --version              Display the version information.\n"
-    << "    --help                 Show this help message.\n";
+    << "    --help                 Show this help message.\n"
+    << "    --clear-cache          Remove every translation kept in the translation cache.\n";
 }
 
 fs::path resolveAndValidateInputFile(const char *input_file) {
@@ -618,24 +1034,6 @@ fs::path resolveAndValidateInputFile(const char *input_file) {
         path.replace_extension("hppplplus");
     }
     
-    std::string in_ext = std::lowercased(path.extension().string());
-    std::array<std::string, 7> extensions = {
-        ".hpppl",
-        ".hppplplus",
-        ".hpppl+"
-        ".pas"
-    };
-    auto bom = utf::bom(path);
-    for (auto extension : extensions) {
-        if (in_ext == extension) {
-            if (bom != utf::BOM::none) {
-                std::cerr << "❓File " << path.filename() << " not utf-8 at " << path.parent_path() << " location.\n";
-                exit(1);
-            }
-        }
-    }
-    
-    
     if (!fs::exists(path)) {
         std::cerr << "❓File " << path.filename() << " not found at " << path.parent_path() << " location.\n";
         exit(1);
@@ -694,95 +1092,886 @@ protected:
     }
 };
 
-// MARK: - Main
-int main(int argc, char **argv) {
-    fs::path inpath, outpath;
-    
-    if (argc == 1) {
-        error();
-        exit(100);
-    }
-    
-    bool verbose = false;
+// MARK: - Build
+
+typedef struct {
     bool minify = false;
     bool reformat = false;
     bool includeProgramName = false;
+    bool dependencies = false;      // write the files read as a Makefile rule, as -MD does for GCC
+    bool phonyDependencies = false; // and give each a rule of its own, as -MP does
+    fs::path dependencyFile;        // where, rather than beside the output with a .d extension
+} options_t;
+
+// Writes PPL out as the UTF-16LE the calculator reads, returning false when it could not be written.
+static bool save(const fs::path& path, std::string_view ppl) {
+    FileOutput file(path, FileOutput::Encoding::UTF16LE);
+    file.write(ppl);
+    return file.commit();
+}
+
+/*
+ Pre-processes the input file and writes the result to the output file, returning false
+ when it could not be written.
+ */
+static bool build(TranslationContext &context, const fs::path& inpath, const fs::path& outpath, const options_t& options) {
+    auto in_ext = std::lowercased(inpath.extension().string());
+    auto out_ext = std::lowercased(outpath.extension().string());
     
-    std::string args(argv[0]);
+    std::string output;
     
-    for (int n = 1; n < argc; n++) {
-        args = argv[n];
-        
-        if (args.at(0) == '-') {
-            if (args == "-o") {
-                if ( ++n >= argc ) {
-                    error();
-                    exit(1);
+    /*
+     PPL that is neither reformatted, compressed nor made into a program is written as it
+     is translated, rather than held whole until the end.
+     */
+    std::unique_ptr<FileOutput> stream;
+    bool streaming = !options.reformat && !options.minify && out_ext != ".hpprgm" && out_ext != ".hpappprgm";
+    
+    // Sources are UTF-8, their byte order mark checked from the same read that translates them.
+    if (in_ext == ".hpppl" || in_ext == ".hppplplus" || in_ext == ".hpppl+") {
+        if (context.includes.bom(inpath) != utf::BOM::none) {
+            diagnostics() << "❓File " << inpath.filename() << " not utf-8 at " << inpath.parent_path() << " location.\n";
+            return false;
+        }
+        if (!utf::valid(context.includes.load(inpath))) {
+            diagnostics() << MessageType::Warning << inpath.filename() << " is not valid utf-8, its malformed characters will be dropped\n";
+        }
+    }
+    
+    std::array<std::string, 2> extensions = {
+        ".hppplplus",
+        ".hpppl+"
+    };
+    for (auto extension : extensions) {
+        if (in_ext == extension) {
+            diagnostics() << "Pre-Processing...\n";
+            if (streaming) {
+                if (outpath == "/dev/stdout") {
+                    stream = std::make_unique<FileOutput>(FileOutput::Encoding::UTF8);
+                } else {
+                    stream = std::make_unique<FileOutput>(outpath, FileOutput::Encoding::UTF16LE);
                 }
-                outpath = resolveOutputFile(argv[n]);
-                continue;
-            }
-            
-            if ( args == "-c" || args == "--compress" ) {
-                minify = true;
-                reformat = false;
-                continue;
-            }
-            
-            if ( args == "-r" || args == "--reformat" ) {
-                reformat = true;
-                minify = false;
-                continue;
-            }
-            
-            if ( args == "--indent" ) {
-                if ( ++n >= argc ) {
-                    error();
-                    exit(1);
+                if (!stream->isOpen()) {
+                    diagnostics() << "❌ Unable to create file " << outpath.filename() << ".\n";
+                    return false;
                 }
-                indentation = std::atoi(argv[n]);
-                continue;
+                translatePPLPlusToPPL(context, inpath, *stream);
+            } else {
+                output = translatePPLPlusToPPL(context, inpath);
             }
-            
-            if ( args == "-n" or args == "--named" ) {
-                includeProgramName = true;
-                continue;
+            if (hasErrors() == true) {
+                diagnostics() << "🛑 errors!" << "\n";
             }
-            
-            if ( args == "-h" or args == "--help" ) {
-                help();
-                return 0;
+            break;
+        }
+    }
+    
+    if (in_ext == ".pas") {
+        diagnostics() << "Pre-Processing...\n";
+        auto code = std::string(context.includes.load(inpath));
+        output = hppplplus::pascal::convertPascalSyntax(code);
+        if (hasErrors() == true) {
+            diagnostics() << "🛑 errors!" << "\n";
+        }
+    }
+    
+    
+    if (output.empty() && !stream) {
+        if (in_ext == ".hpprgm" || in_ext == ".hpappprgm") {
+            std::wstring prgm = hpprgm::source(inpath);
+            output = utf::to_string(prgm);
+        }
+    }
+    
+    if (output.empty() && !stream) {
+        for (const addon_t &addon : context.addons) {
+            if (in_ext != addon.extension) continue;
+            auto result = convert(addon, inpath);
+            if (result.exitCode == 0) {
+                output = result.out;
             }
-            
+            break;
+        }
+    }
+    
+    if (output.empty() && !stream) {
+        output = context.includes.decode(inpath);
+    }
+    
+    if (options.reformat) {
+        Profiler::Scope scope(Stage::Reformat);
+        output = reformat::prgm(output, context.indentation);
+    }
+    
+    if (options.minify) {
+        // Percentage Reduction = (Original Size - New Size) / Original Size * 100
+        std::ifstream::pos_type original_size = output.length();
+        {
+            Profiler::Scope scope(Stage::Minify);
+            output = minifier::minify(output);
+        }
+        std::ifstream::pos_type new_size = output.length();
+        
+        // Create a locale with the custom comma-based numpunct
+        std::locale commaLocale(std::locale::classic(), new comma_numpunct);
+        diagnostics().imbue(commaLocale);
+        
+        diagnostics() << "PPL Code (deflated " << (original_size - new_size) * 100 / original_size << "%)\n";
+    }
+    
+    
+    if (outpath == "/dev/stdout") {
+        Profiler::Scope scope(Stage::Write);
+        if (stream) {
+            stream->commit();
+        } else {
+            std::cout << output;
+        }
+        diagnostics() << '\n';
+    } else {
+        Profiler::Scope scope(Stage::Write);
+        if (out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
+            hpprgm::write(outpath, output, options.includeProgramName);
+        } else {
+            if (stream ? !stream->commit() : !save(outpath, output)) {
+                diagnostics() << "❌ Unable to create file " << outpath.filename() << ".\n";
+                return false;
+            }
+        }
+    
+        diagnostics() << "Successfully created " << outpath.filename() << "\n";
+    }
+    
+    
+    return true;
+}
+
+// Display elasps time in secononds.
+static void reportElapsedTime(const long long elapsed_time) {
+    if (elapsed_time / 1e9 < 1.0) {
+        std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e6 << " milliseconds\n";
+    } else {
+        std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e9 << " seconds\n";
+    }
+}
+
+// A project is only ever built by buildProject, with its include and lib directories and its note.
+static bool isProject(const fs::path& path) {
+    return std::lowercased(path.extension().string()) == ".xprimeproj";
+}
+
+// MARK: - Dependency File
+
+// A path as written in a Makefile, with spaces, `#` and `$` escaped.
+static std::string makeEscaped(const fs::path& path) {
+    std::string str;
+    
+    for (char c : path.generic_string()) {
+        if (c == ' ' || c == '#') str += '\\';
+        if (c == '$') str += '$';
+        str += c;
+    }
+    return str;
+}
+
+// A dependency relative to the current directory when within it, as GCC writes those it finds.
+static fs::path dependencyPath(const fs::path& path) {
+    auto relative = path.lexically_proximate(fs::current_path());
+    if (relative.empty() || *relative.begin() == "..") return path;
+    return relative;
+}
+
+/*
+ Writes the files read building `outpath`, beginning with `inpath`, as a Makefile rule,
+ so make can tell when it needs building again. Files that were looked for but not
+ found are left out.
+ */
+static bool writeDependencyFile(const fs::path& inpath, const fs::path& outpath, const std::map<fs::path, std::string>& dependencies, const options_t& options) {
+    fs::path path = options.dependencyFile;
+    if (path.empty()) path = fs::path(outpath).replace_extension(".d");
+    
+    auto source = fs::absolute(inpath).lexically_normal();
+    std::vector<fs::path> prerequisites = {dependencyPath(source)};
+    for (const auto &dependency : dependencies) {
+        if (dependency.first == source || dependency.second == "-") continue;
+        prerequisites.push_back(dependencyPath(dependency.first));
+    }
+    
+    std::ofstream outfile(path);
+    if (!outfile.is_open()) {
+        diagnostics() << "❌ Unable to create file " << path.filename() << ".\n";
+        return false;
+    }
+    
+    outfile << makeEscaped(outpath) << ":";
+    for (const auto &prerequisite : prerequisites) {
+        outfile << " \\\n  " << makeEscaped(prerequisite);
+    }
+    outfile << "\n";
+    
+    if (options.phonyDependencies) {
+        for (size_t i = 1; i < prerequisites.size(); ++i) {
+            outfile << "\n" << makeEscaped(prerequisites[i]) << ":\n";
+        }
+    }
+    
+    return !outfile.fail();
+}
+
+// MARK: - Batch
+
+// The input files listed one per line, blank lines and lines beginning with `#` aside.
+static std::vector<std::string> readBatchList(const fs::path& path) {
+    std::vector<std::string> inputs;
+    std::ifstream infile(path);
+    std::string line;
+    
+    if (!infile.is_open()) {
+        std::cerr << "❓File " << path.filename() << " not found at " << path.parent_path() << " location.\n";
+        exit(1);
+    }
+    
+    while (std::getline(infile, line)) {
+        trim(line);
+        if (line.empty() || line.front() == '#') continue;
+        inputs.push_back(line);
+    }
+    return inputs;
+}
+
+// The settings given on the command line that are not part of the translation state.
+static void copySettings(const TranslationContext& from, TranslationContext& to) {
+    to.aliases.verbose = from.aliases.verbose;
+    to.regexp.verbose = from.regexp.verbose;
+    to.regexp.profile = from.regexp.profile;
+    to.directives.verbose = from.directives.verbose;
+    to.includes.once = from.includes.once;
+}
+
+// Runs each job on up to `jobs` threads, writing out the messages of each as soon as it and all those before it are done.
+static void runInOrder(const size_t jobs, std::vector<std::ostringstream>& messages, const std::function<void(size_t)>& job) {
+    std::vector<bool> done(messages.size());
+    std::mutex mutex;
+    size_t next = 0;
+    
+    WorkPool(jobs).run(messages.size(), [&](const size_t i) {
+        job(i);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        done[i] = true;
+        while (next < done.size() && done[next]) {
+            std::cerr << messages[next++].str();
+        }
+    });
+}
+
+/*
+ Builds each of the input files, up to `jobs` of them at once. Every file is translated
+ on a context of its own, starting from the state left by the command line options,
+ while compiled regular expressions, translated includes and add-on outputs are shared
+ by all. The messages of each file are written out in the order the files were given,
+ as soon as it and all those before it are built.
+ 
+ Output paths are all resolved beforehand, so that no two files write the same one.
+ */
+static bool batch(const TranslationContext& context, const std::vector<fs::path>& inputs, const fs::path& outdir, const options_t& options, const std::map<fs::path, std::string>& libraries, const size_t jobs) {
+    typedef struct {
+        fs::path inpath;
+        fs::path outpath;
+        options_t options;
+        bool built = false;
+    } result_t;
+    
+    std::vector<result_t> results(inputs.size());
+    std::vector<std::ostringstream> messages(inputs.size());
+    std::map<fs::path, fs::path> written;
+    
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        result_t &result = results[i];
+        result.inpath = inputs[i];
+        result.outpath = outdir;
+        result.options = options;
+        
+        if (isProject(result.inpath)) {
+            std::cerr << "❌ error: " << inputs[i] << " is a project, which is built on its own rather than with other input files.\n";
+            return false;
+        }
+        result.outpath = resolveOutputPath(result.inpath, result.outpath);
+        
+        if (result.outpath == result.inpath) {
+            std::cerr << "❌ error: Input file and output file cannot be the same. Choose a different output path.\n";
+            return false;
+        }
+        auto [it, inserted] = written.try_emplace(fs::weakly_canonical(result.outpath), inputs[i]);
+        if (!inserted) {
+            std::cerr << "❌ error: " << inputs[i] << " and " << it->second << " would both be built into " << result.outpath << ".\n";
+            return false;
+        }
+    }
+    
+    const std::string baseline = translationState(context, true);
+    
+    runInOrder(jobs, messages, [&](const size_t i) {
+        result_t &result = results[i];
+        TranslationContext translation;
+        TranslationContext::Binding binding(translation);
+        
+        translation.diagnostics = &messages[i];
+        copySettings(context, translation);
+        restoreTranslationState(translation, baseline);
+        
+        messages[i] << result.inpath.string() << "\n";
+        translation.beginRecording();
+        try {
+            result.built = build(translation, result.inpath, result.outpath, result.options);
+        } catch (const std::exception &e) {
+            diagnostics() << MessageType::CriticalError << e.what() << "\n";
+        }
+        auto dependencies = translation.endRecording();
+        
+        if (result.built && options.dependencies) {
+            dependencies.insert(libraries.begin(), libraries.end());
+            result.built = writeDependencyFile(result.inpath, result.outpath, dependencies, result.options);
+        }
+        
+        if (translation.regexp.profile) translation.regexp.report(messages[i], 20);
+    });
+    
+    return std::all_of(results.begin(), results.end(), [](const result_t &result) { return result.built; });
+}
+
+// MARK: - Project
+
+/*
+ Builds the outputs of a project: its program and, should it have an info.note, its
+ note. Each is only built when the record of the last build shows it out of date, and
+ those that are, are built at the same time on up to `jobs` threads.
+ 
+ The program is built where `program` says when given, rather than where the project
+ does. Given `inputs`, every file the outputs are built from is added to it with its
+ digest, whether read now or as recorded when the output was last built, along with
+ the project itself and its note, even before it exists.
+ */
+static bool buildProject(TranslationContext& context, const fs::path& path, options_t options, const size_t jobs, const bool verbose, const fs::path& program = fs::path(), std::map<fs::path, std::string> *inputs = nullptr) {
+    typedef struct {
+        fs::path output;
+        std::string settings;
+        std::function<bool(std::ostream &messages, std::map<fs::path, std::string> &dependencies)> make;
+        bool built = false;
+        std::map<fs::path, std::string> dependencies;
+    } step_t;
+    
+    auto project = Project::load(path);
+    if (!project) {
+        std::cerr << "❌ error: " << path.filename() << " is not a valid project.\n";
+        return false;
+    }
+    
+    if (!project->include.empty()) {
+        auto include = project->resolve(project->include);
+        if (fs::is_directory(include)) context.directives.systemIncludePath.push_front(include);
+    }
+    if (!project->lib.empty()) {
+        auto lib = project->resolve(project->lib);
+        if (fs::is_directory(lib)) loadRegexLibs(context, lib, verbose);
+    }
+    
+    if (project->compression) {
+        options.minify = true;
+        options.reformat = false;
+    }
+    if (project->includeProgramName) options.includeProgramName = true;
+    
+    const std::string baseline = translationState(context, true);
+    std::vector<step_t> steps;
+    
+    {
+        ArchiveWriter settings;
+        settings.write(translationState(context, false));
+        settings.write(options.minify);
+        settings.write(options.reformat);
+        settings.write(options.includeProgramName);
+        settings.write(context.indentation);
+        
+        fs::path inpath = project->source();
+        fs::path outpath = program.empty() ? project->program() : resolveOutputPath(inpath, program);
+        steps.push_back({
+            .output = outpath,
+            .settings = TranslationCache::digest(settings.data()),
+            .make = [&, inpath, outpath](std::ostream &messages, std::map<fs::path, std::string> &dependencies) {
+                TranslationContext translation;
+                TranslationContext::Binding binding(translation);
+                bool built = false;
+                
+                translation.diagnostics = &messages;
+                copySettings(context, translation);
+                restoreTranslationState(translation, baseline);
+                
+                translation.beginRecording();
+                try {
+                    built = build(translation, inpath, outpath, options);
+                } catch (const std::exception &e) {
+                    diagnostics() << MessageType::CriticalError << e.what() << "\n";
+                }
+                dependencies = translation.endRecording();
+                dependencies.emplace(fs::absolute(inpath).lexically_normal(), TranslationCache::fileDigest(inpath));
+                
+                return built && !hasErrors();
+            }
+        });
+    }
+    
+    if (fs::exists(project->note())) {
+        fs::path inpath = project->note(), outpath = project->builtNote();
+        std::vector<std::string> arguments = {inpath.string(), "-o", outpath.string()};
+        if (project->plainFallbackText) arguments.push_back("--plain-fallback");
+        
+        steps.push_back({
+            .output = outpath,
+            .settings = TranslationCache::digest(project->plainFallbackText ? "hpnote --plain-fallback" : "hpnote"),
+            .make = [inpath, outpath, arguments](std::ostream &messages, std::map<fs::path, std::string> &dependencies) {
+                dependencies.emplace(inpath, TranslationCache::fileDigest(inpath));
+                
+                auto result = tool::runTool("hpnote", arguments);
+                messages << result.out << result.err;
+                if (!result.err.empty() && result.err.back() != '\n') messages << "\n";
+                if (result.exitCode != 0) {
+                    messages << "❌ Unable to create file " << outpath.filename() << ".\n";
+                    return false;
+                }
+                return true;
+            }
+        });
+    }
+    
+    BuildRecord record(project->path);
+    std::vector<std::ostringstream> messages(steps.size());
+    
+    runInOrder(jobs, messages, [&](const size_t i) {
+        step_t &step = steps[i];
+        
+        if (record.upToDate(step.output, step.settings)) {
+            messages[i] << step.output.filename() << " is up to date\n";
+            step.built = true;
+            return;
+        }
+        
+        step.built = step.make(messages[i], step.dependencies);
+    });
+    
+    for (const auto &step : steps) {
+        if (step.dependencies.empty()) continue;
+        
+        if (step.built) {
+            record.record(step.output, step.settings, step.dependencies);
+        } else {
+            record.forget(step.output);
+        }
+    }
+    record.save();
+    
+    if (inputs) {
+        inputs->emplace(fs::absolute(path).lexically_normal(), TranslationCache::fileDigest(path));
+        inputs->emplace(fs::absolute(project->note()).lexically_normal(), TranslationCache::fileDigest(project->note()));
+        for (const auto &step : steps) {
+            auto dependencies = step.dependencies.empty() ? record.dependencies(step.output) : step.dependencies;
+            inputs->insert(dependencies.begin(), dependencies.end());
+        }
+    }
+    
+    return std::all_of(steps.begin(), steps.end(), [](const step_t &step) { return step.built; });
+}
+
+// MARK: - Watch
+
+/*
+ Builds, then builds again whenever the input file, or any file read building it,
+ changes, until interrupted. `build` builds, giving the files it read with their
+ digests, be it a single file or a project.
+ 
+ The files read are those the translation cache records as dependencies, so the
+ include graph is the one found by the last build. Only the input file is translated
+ again, as unchanged includes come from the translation cache and unchanged add-on
+ inputs from the add-on outputs kept. Of a project, only the outputs its build record
+ shows out of date are built again.
+ */
+static int watch(TranslationContext &context, const std::function<void(std::map<fs::path, std::string> &dependencies)> &build) {
+    const std::string baseline = translationState(context, true);
+    Watcher watcher;
+    bool polling = false;
+    
+    while (true) {
+        resetTranslationState(context, baseline);
+        
+        Timer timer;
+        std::map<fs::path, std::string> dependencies;
+        build(dependencies);
+        reportElapsedTime(timer.elapsed());
+        
+        std::set<fs::path> files;
+        for (const auto &dependency : dependencies) files.insert(dependency.first);
+        watcher.watch(files);
+        if (watcher.polling() && !polling) {
+            std::cerr << "⚠️ warning: Files cannot be watched here, so are polled for changes instead.\n";
+        }
+        polling = watcher.polling();
+        std::cerr << "Watching " << files.size() << " files...\n";
+        
+        // Any file saved unchanged is no reason to build again. All are checked at first, in case any changed while building.
+        auto changed = files;
+        while (std::none_of(changed.begin(), changed.end(), [&](const fs::path &path) {
+            return TranslationCache::fileDigest(path) != dependencies[path];
+        })) {
+            changed = watcher.wait();
+        }
+        
+        for (const auto &path : changed) {
+            std::cerr << path.filename() << " changed\n";
+        }
+    }
+    
+    return 0;
+}
+
+// MARK: - Server
+
+/*
+ Answers newline-delimited JSON requests read from stdin, one JSON response per line
+ on stdout, for as long as stdin stays open.
+ 
+ A request names a file with "path", or gives the code itself with "source", "path"
+ then only locating it for messages and relative includes. Options are "compress",
+ "reformat" and "named", with "output" naming a file to write rather than returning
+ the PPL. Any "id" is echoed back.
+ 
+ Every request starts from the state left by the command line options, but compiled
+ regular expressions, translated includes and add-on outputs stay warm between them.
+ */
+static int serve(TranslationContext &context, const bool includeProgramName) {
+    const std::string baseline = translationState(context, true);
+    
+    std::ostream out(std::cout.rdbuf());
+    std::string line;
+    
+    while (std::getline(std::cin, line)) {
+        if (is_all_whitespace(line)) continue;
+        
+        Timer timer;
+        std::string response = "{";
+        std::ostringstream reported;
+        std::string output;
+        bool ok = false;
+        
+        auto request = json::parse(line);
+        if (!request) {
+            out << "{\"ok\":false,\"diagnostics\":[\"invalid request\"]}" << std::endl;
+            continue;
+        }
+        
+        auto text = [&](const std::string &key) {
+            auto it = request->find(key);
+            return it == request->end() ? std::string() : it->second.string;
+        };
+        auto boolean = [&](const std::string &key, bool value) {
+            auto it = request->find(key);
+            return it == request->end() || it->second.type != json::value_t::Type::Boolean ? value : it->second.boolean;
+        };
+        
+        if (auto it = request->find("id"); it != request->end()) {
+            response += "\"id\":";
+            if (it->second.type == json::value_t::Type::String) {
+                response += json::quote(it->second.string);
+            } else if (it->second.type == json::value_t::Type::Number) {
+                std::ostringstream number;
+                number << it->second.number;
+                response += number.str();
+            } else {
+                response += "null";
+            }
+            response += ",";
+        }
+        
+        fs::path path = fs::expand_tilde(text("path"));
+        fs::path outpath = fs::expand_tilde(text("output"));
+        bool hasSource = request->contains("source");
+        if (path.empty()) path = fs::current_path() / "untitled.hpppl+";
+        
+        resetTranslationState(context, baseline);
+        
+        // Everything reported while building belongs to the response.
+        context.diagnostics = &reported;
+        
+        try {
+            auto ext = std::lowercased(path.extension().string());
+            if (hasSource) {
+                output = translatePPLPlusToPPL(context, path, text("source"));
+            } else if (!fs::exists(path)) {
+                diagnostics() << MessageType::Error << path.filename() << " file not found\n";
+            } else if (ext == ".hppplplus" || ext == ".hpppl+") {
+                output = translatePPLPlusToPPL(context, path);
+            } else if (ext == ".pas") {
+                output = hppplplus::pascal::convertPascalSyntax(std::string(context.includes.load(path)));
+            } else {
+                output = context.includes.decode(path);
+            }
+            
+            if (boolean("reformat", false)) {
+                output = reformat::prgm(output, context.indentation);
+            } else if (boolean("compress", false)) {
+                output = minifier::minify(output);
+            }
+            
+            if (!outpath.empty() && !hasErrors()) {
+                auto ext = std::lowercased(outpath.extension().string());
+                if (ext == ".hpprgm" || ext == ".hpappprgm") {
+                    hpprgm::write(outpath, output, boolean("named", includeProgramName));
+                } else if (!save(outpath, output)) {
+                    diagnostics() << MessageType::Error << "unable to create file " << outpath.filename() << "\n";
+                }
+            }
+            ok = !hasErrors();
+        } catch (const std::exception &e) {
+            diagnostics() << MessageType::CriticalError << e.what() << "\n";
+        }
+        
+        context.diagnostics = &std::cerr;
+        
+        response += "\"ok\":";
+        response += ok ? "true" : "false";
+        if (outpath.empty()) response += ",\"output\":" + json::quote(output);
+        
+        response += ",\"diagnostics\":[";
+        std::istringstream messages(reported.str());
+        bool first = true;
+        std::string message;
+        while (std::getline(messages, message)) {
+            if (is_all_whitespace(message)) continue;
+            if (!first) response += ",";
+            response += json::quote(message);
+            first = false;
+        }
+        response += "],\"elapsed_ns\":" + std::to_string(timer.elapsed()) + "}";
+        
+        out << response << std::endl;
+    }
+    
+    return 0;
+}
+
+// MARK: - Main
+int main(int argc, char **argv) {
+    fs::path inpath, outpath;
+    TranslationContext context;
+    TranslationContext::Binding binding(context);
+    
+    if (argc == 1) {
+        error();
+        exit(100);
+    }
+    
+    bool verbose = false;
+    options_t options;
+    bool profile = false;
+    bool server = false;
+    bool watching = false;
+    bool batching = false;
+    size_t jobs = std::thread::hardware_concurrency();
+    std::vector<fs::path> inputs;
+    std::vector<fs::path> libraryPaths;
+    std::map<fs::path, std::string> libraries;
+    fs::path profilePath;
+    fs::path projectPath;
+    
+    std::string args(argv[0]);
+    
+    // Compile the built-in patterns up front, measuring what they cost on their own.
+    Timer patternsTimer;
+    Patterns::shared();
+    long long patternsTime = patternsTimer.elapsed();
+    
+    for (int n = 1; n < argc; n++) {
+        args = argv[n];
+        
+        if (args.at(0) == '-') {
+            if (args == "-o") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                outpath = resolveOutputFile(argv[n]);
+                continue;
+            }
+            
+            if ( args == "-c" || args == "--compress" ) {
+                options.minify = true;
+                options.reformat = false;
+                continue;
+            }
+            
+            if ( args == "-r" || args == "--reformat" ) {
+                options.reformat = true;
+                options.minify = false;
+                continue;
+            }
+            
+            if ( args == "--indent" ) {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                context.indentation = std::atoi(argv[n]);
+                continue;
+            }
+            
+            if ( args == "-n" or args == "--named" ) {
+                options.includeProgramName = true;
+                continue;
+            }
+            
+            if ( args == "-h" or args == "--help" ) {
+                help();
+                return 0;
+            }
+            
             if (args == "--version") {
                 std::cout << VERSION_NUMBER << "." << BUNDLE_VERSION << "\n";
                 return 0;
             }
             
+            if (args == "--clear-cache") {
+                if (!cache.clear()) {
+                    std::cerr << "❌ error: Unable to clear the translation cache at " << cache.directory << ".\n";
+                    return 1;
+                }
+                return 0;
+            }
+            
             if (args == "--build") {
                 std::cout << NUMERIC_BUILD << "\n";
                 return 0;
             }
             
             if (args == "-v" || args == "--verbose") {
-                Singleton::shared()->aliases.verbose = true;
-                directives.verbose = true;
-                Singleton::shared()->regexp.verbose = true;
+                context.aliases.verbose = true;
+                context.directives.verbose = true;
+                context.regexp.verbose = true;
                 verbose = true;
                 
                 continue;
             }
             
+            if (args == "--profile") {
+                profile = true;
+                Profiler::shared().enabled = true;
+                continue;
+            }
+            
+            if (args == "--profile-json") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                profilePath = fs::expand_tilde(argv[n]);
+                Profiler::shared().enabled = true;
+                continue;
+            }
+            
+            if (args == "--profile-regex") {
+                context.regexp.profile = true;
+                continue;
+            }
+            
+            if (args == "--include-once") {
+                context.includes.once = true;
+                continue;
+            }
+            
+            if (args == "-j" || args == "--jobs") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                jobs = std::atoi(argv[n]);
+                continue;
+            }
+            
+            if (args.starts_with("-j")) {
+                jobs = std::atoi(args.substr(2).c_str());
+                continue;
+            }
+            
+            if (args == "--batch") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                for (const auto &input : readBatchList(fs::expand_tilde(argv[n]))) {
+                    inputs.push_back(resolveAndValidateInputFile(input.c_str()));
+                }
+                batching = true;
+                continue;
+            }
+            
+            if (args == "--project") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                projectPath = resolveAndValidateInputFile(argv[n]);
+                continue;
+            }
+            
+            if (args == "--watch") {
+                watching = true;
+                continue;
+            }
+            
+            if (args == "--server") {
+                server = true;
+                continue;
+            }
+            
+            if (args == "--no-cache") {
+                cache.enabled = false;
+                continue;
+            }
+            
             if (args.starts_with("-I")) {
                 fs::path path = fs::path(args.substr(2)).has_filename() ? fs::path(args.substr(2)) : fs::path(args.substr(2)).parent_path();
                 path = fs::expand_tilde(path);
-                directives.systemIncludePath.push_front(path);
+                context.directives.systemIncludePath.push_front(path);
                 continue;
             }
             
             if (args.starts_with("-L")) {
                 fs::path path = fs::path(args.substr(2)).has_filename() ? fs::path(args.substr(2)) : fs::path(args.substr(2)).parent_path();
-                loadRegexLibs(fs::expand_tilde(path), verbose);
+                libraryPaths.push_back(fs::expand_tilde(path));
+                continue;
+            }
+            
+            if (args == "-MD") {
+                options.dependencies = true;
+                continue;
+            }
+            
+            if (args == "-MP") {
+                options.phonyDependencies = true;
+                continue;
+            }
+            
+            if (args == "-MF") {
+                if ( ++n >= argc ) {
+                    error();
+                    exit(1);
+                }
+                options.dependencies = true;
+                options.dependencyFile = fs::expand_tilde(argv[n]);
+                continue;
+            }
+            
+            if (args.starts_with("-MF")) {
+                options.dependencies = true;
+                options.dependencyFile = fs::expand_tilde(args.substr(3));
                 continue;
             }
             
@@ -790,128 +1979,157 @@ int main(int argc, char **argv) {
             exit(1);
         }
         
-        inpath = resolveAndValidateInputFile(argv[n]);
+        inputs.push_back(resolveAndValidateInputFile(argv[n]));
     }
     
-    outpath = resolveOutputPath(inpath, outpath);
+    if (!inputs.empty()) inpath = inputs.front();
+    if (inputs.size() > 1) batching = true;
+    addonJobs = std::max<size_t>(1, jobs);
     
-    if (outpath == inpath) {
-        std::cerr << "❌ error: Input file and output file cannot be the same. Choose a different output path.\n";
-        exit(1);
+    // A project given as the only input file is built just as --project builds it.
+    if (projectPath.empty() && !batching && !inpath.empty() && isProject(inpath)) {
+        projectPath = inpath;
+        inputs.clear();
+        inpath.clear();
     }
     
-    auto in_ext = std::lowercased(inpath.extension().string());
-    auto out_ext = std::lowercased(outpath.extension().string());
-    
-    
-    std::string str;
-    
-    str = "{$DEFINE __hppplplus}";
-    directives.parse(str);
-    
-    // Start measuring time
-    Timer timer;
-    
-    std::string output;
-    
-    std::array<std::string, 2> extensions = {
-        ".hppplplus",
-        ".hpppl+"
-    };
-    for (auto extension : extensions) {
-        if (in_ext == extension) {
-            std::cerr << "Pre-Processing...\n";
-            output = translatePPLPlusToPPL(inpath);
-            if (hasErrors() == true) {
-                std::cerr << "🛑 errors!" << "\n";
-            }
-            break;
+    if (!projectPath.empty()) {
+        if (!inputs.empty()) {
+            std::cerr << "❌ error: A project is built on its own, not with other input files.\n";
+            exit(1);
+        }
+        if (server) {
+            std::cerr << "❌ error: A project cannot be served.\n";
+            exit(1);
+        }
+        if (options.dependencies) {
+            std::cerr << "❌ error: A project keeps its own record of the files read building it, so takes neither -MD nor -MF.\n";
+            exit(1);
         }
     }
     
-    if (in_ext == ".pas") {
-        std::cerr << "Pre-Processing...\n";
-        auto code = utf::load(inpath);
-        output = hppplplus::pascal::convertPascalSyntax(code);
-        if (hasErrors() == true) {
-            std::cerr << "🛑 errors!" << "\n";
-        }
+    if (batching && (server || watching)) {
+        std::cerr << "❌ error: Only a single input file can be served or watched.\n";
+        exit(1);
     }
     
+    // Libraries are loaded once every option is known, so they can be listed as dependencies.
+    if (options.dependencies) context.beginRecording();
+    for (const auto &path : libraryPaths) {
+        loadRegexLibs(context, path, verbose);
+    }
+    if (options.dependencies) libraries = context.endRecording();
     
-    if (output.empty()) {
-        if (in_ext == ".hpprgm" || in_ext == ".hpappprgm") {
-            std::wstring prgm = hpprgm::source(inpath);
-            output = utf::to_string(prgm);
-        }
+    if (server) {
+        if (verbose) cache.enabled = false;
+        
+        std::string str = "{$DEFINE __hppplplus}";
+        context.directives.parse(str);
+        return serve(context, options.includeProgramName);
     }
     
-    if (output.empty()) {
-        for (const addon_t &addon : addons) {
-            if (in_ext != addon.extension) continue;
-            std::vector<std::string> arguments = {inpath.string(), "-o", "/dev/stdout"};
-            arguments.insert(arguments.end(), addon.arguments.begin(), addon.arguments.end());
-            auto result = tool::runTool(addon.command, arguments);
-            if (result.exitCode == 0) {
-                output = result.out;
-            }
-            break;
+    if (!projectPath.empty()) {
+        if (verbose) cache.enabled = false;
+        
+        std::string str = "{$DEFINE __hppplplus}";
+        context.directives.parse(str);
+        
+        if (watching) {
+            return watch(context, [&](std::map<fs::path, std::string> &dependencies) {
+                buildProject(context, projectPath, options, jobs, verbose, outpath, &dependencies);
+            });
         }
+        
+        Timer timer;
+        bool built = buildProject(context, projectPath, options, jobs, verbose, outpath);
+        reportElapsedTime(timer.elapsed());
+        return built ? 0 : 1;
     }
     
-    if (output.empty()) {
-        auto bom = utf::bom(inpath);
-        if (bom != utf::BOM::none) {
-            auto prgm = utf::load(inpath, bom);
-            output = utf::to_string(prgm);
-        } else {
-            output = utf::load(inpath);
+    if (batching) {
+        if (!outpath.empty() && !fs::is_directory(outpath)) {
+            std::cerr << "❌ error: With more than one input file the output must be a directory.\n";
+            exit(1);
+        }
+        if (!options.dependencyFile.empty()) {
+            std::cerr << "❌ error: With more than one input file each dependency file is written beside its output, -MD rather than -MF.\n";
+            exit(1);
+        }
+    } else {
+        outpath = resolveOutputPath(inpath, outpath);
+        
+        if (outpath == inpath) {
+            std::cerr << "❌ error: Input file and output file cannot be the same. Choose a different output path.\n";
+            exit(1);
+        }
+        if (outpath == "/dev/stdout" && options.dependencies && options.dependencyFile.empty()) {
+            std::cerr << "❌ error: Writing to stdout, the dependency file must be named with -MF.\n";
+            exit(1);
         }
     }
     
-    if (reformat == true) {
-        output = reformat::prgm(output, indentation);
+    // Verbose output reports everything translation does, so nothing comes from the cache.
+    if (verbose) cache.enabled = false;
+    // A file restored from the cache applies no regular expressions, which would leave them out of the report.
+    if (context.regexp.profile) cache.enabled = false;
+    
+    if (verbose) {
+        std::cerr << "Built-in patterns compiled in " << std::fixed << std::setprecision(2) << patternsTime / 1e6 << " milliseconds\n";
     }
     
-    if (minify == true) {
-        // Percentage Reduction = (Original Size - New Size) / Original Size * 100
-        std::ifstream::pos_type original_size = output.length();
-        output = minifier::minify(output);
-        std::ifstream::pos_type new_size = output.length();
-        
-        // Create a locale with the custom comma-based numpunct
-        std::locale commaLocale(std::locale::classic(), new comma_numpunct);
-        std::cerr.imbue(commaLocale);
-        
-        std::cerr << "PPL Code (deflated " << (original_size - new_size) * 100 / original_size << "%)\n";
+    std::string str;
+    
+    str = "{$DEFINE __hppplplus}";
+    context.directives.parse(str);
+    
+    if (watching) {
+        return watch(context, [&](std::map<fs::path, std::string> &dependencies) {
+            context.beginRecording();
+            try {
+                build(context, inpath, outpath, options);
+            } catch (const std::exception &e) {
+                diagnostics() << MessageType::CriticalError << e.what() << "\n";
+            }
+            dependencies = context.endRecording();
+            dependencies.emplace(fs::absolute(inpath).lexically_normal(), TranslationCache::fileDigest(inpath));
+        });
     }
     
+    // Start measuring time
+    Timer timer;
     
-    if (outpath == "/dev/stdout") {
-        std::cout << output;
-        std::cerr << '\n';
+    if (batching) {
+        if (!batch(context, inputs, outpath, options, libraries, jobs)) exit(1);
     } else {
-        if (out_ext == ".hpprgm" || out_ext == ".hpappprgm") {
-            auto programName = inpath.stem().string();
-            hpprgm::write(outpath, output, includeProgramName);
-        } else {
-            if (!utf::save(outpath, utf::to_wstring(output), utf::BOM::le)) {
-                std::cerr << "❌ Unable to create file " << outpath.filename() << ".\n";
-                exit(1);
-            }
+        if (options.dependencies) context.beginRecording();
+        if (!build(context, inpath, outpath, options)) exit(1);
+        
+        if (options.dependencies) {
+            auto dependencies = context.endRecording();
+            dependencies.insert(libraries.begin(), libraries.end());
+            if (!writeDependencyFile(inpath, outpath, dependencies, options)) exit(1);
         }
-    
-        std::cerr << "Successfully created " << outpath.filename() << "\n";
     }
     
     // Stop measuring time and calculate the elapsed time.
     long long elapsed_time = timer.elapsed();
+    reportElapsedTime(elapsed_time);
     
-    // Display elasps time in secononds.
-    if (elapsed_time / 1e9 < 1.0) {
-        std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e6 << " milliseconds\n";
-    } else {
-        std::cerr << "✅ Completed in " << std::fixed << std::setprecision(2) << elapsed_time / 1e9 << " seconds\n";
+    if (profile) {
+        Profiler::shared().report(std::cerr, elapsed_time);
+    }
+    
+    if (context.regexp.profile && !batching) {
+        context.regexp.report(std::cerr, 20);
+    }
+    
+    if (!profilePath.empty()) {
+        std::ofstream outfile(profilePath);
+        if (outfile.is_open()) {
+            Profiler::shared().reportJSON(outfile, elapsed_time);
+        } else {
+            std::cerr << "❌ Unable to create file " << profilePath.filename() << ".\n";
+        }
     }
     
     return 0;
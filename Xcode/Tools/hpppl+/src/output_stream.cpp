@@ -0,0 +1,290 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "output_stream.hpp"
+#include "patterns.hpp"
+#include "profiler.hpp"
+#include "utf.hpp"
+
+#include <regex>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#if defined(_WIN32)
+    #include <io.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using hppplplus::PostPasses;
+using hppplplus::FileOutput;
+using hppplplus::Patterns;
+using hppplplus::Profiler;
+
+namespace fs = std::filesystem;
+
+// Output is written in blocks of this size.
+static const size_t blockSize = 64 * 1024;
+
+// MARK: - Post Passes
+
+void PostPasses::write(std::string_view chunk) {
+    Profiler::Scope scope(Profiler::Stage::PostPasses);
+    
+    _pending.append(chunk);
+    
+    size_t end = _pending.rfind(';');
+    if (end == std::string::npos) return;
+    
+    _collapsed = std::regex_replace(_pending.substr(0, end + 1), Patterns::shared().uses, "\n");
+    _pending.erase(0, end + 1);
+    collapse(_collapsed);
+}
+
+void PostPasses::close(void) {
+    {
+        Profiler::Scope scope(Profiler::Stage::PostPasses);
+        
+        // What is left holds no `;`, so no clause.
+        collapse(_pending);
+        _pending.clear();
+        
+        if (_newlines) _next.write(std::string(std::min<size_t>(_newlines, 2), '\n'));
+        _newlines = 0;
+    }
+    _next.close();
+}
+
+// Passes text on with every run of three or more newlines made two.
+void PostPasses::collapse(std::string_view text) {
+    std::string output;
+    output.reserve(text.length() + 2);
+    
+    for (size_t pos = 0; pos < text.length(); ) {
+        size_t newline = text.find('\n', pos);
+        if (newline == std::string_view::npos) newline = text.length();
+        
+        if (newline > pos) {
+            if (_newlines) output.append(std::min<size_t>(_newlines, 2), '\n');
+            _newlines = 0;
+            output.append(text.substr(pos, newline - pos));
+        }
+        
+        size_t run = text.find_first_not_of('\n', newline);
+        if (run == std::string_view::npos) run = text.length();
+        _newlines += run - newline;
+        pos = run;
+    }
+    
+    if (!output.empty()) _next.write(output);
+}
+
+// MARK: - File Output
+
+FileOutput::FileOutput(const Encoding encoding) : _fd(1), _encoding(encoding), _buffer(blockSize) {
+#if defined(_WIN32)
+    _setmode(_fd, _O_BINARY);
+#endif
+}
+
+FileOutput::FileOutput(const fs::path &path, const Encoding encoding) : _owned(true), _encoding(encoding), _path(path), _buffer(blockSize) {
+    _temporary = path;
+    _temporary += ".tmp";
+
+#if defined(_WIN32)
+    _fd = _wopen(_temporary.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    _fd = open(_temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+#endif
+}
+
+FileOutput::~FileOutput() {
+    if (!_owned || _fd < 0) return;
+    
+    // Never committed, so what was written is of no use.
+#if defined(_WIN32)
+    _close(_fd);
+#else
+    ::close(_fd);
+#endif
+    std::error_code ec;
+    fs::remove(_temporary, ec);
+}
+
+void FileOutput::write(std::string_view chunk) {
+    if (_fd < 0) return;
+    
+    if (_encoding == Encoding::UTF8) {
+        while (!chunk.empty()) {
+            size_t length = std::min(chunk.length(), _buffer.size() - _used);
+            std::copy(chunk.begin(), chunk.begin() + length, _buffer.begin() + _used);
+            _used += length;
+            chunk.remove_prefix(length);
+            if (_used == _buffer.size()) flush();
+        }
+        return;
+    }
+    
+    // A sequence split by the last chunk is completed from this one first.
+    if (!_partial.empty()) {
+        auto lead = static_cast<uint8_t>(_partial[0]);
+        size_t length = (lead & 0b11110000) == 0b11100000 ? 3 : 2;
+        size_t needed = std::min(length - _partial.length(), chunk.length());
+        _partial.append(chunk.substr(0, needed));
+        chunk.remove_prefix(needed);
+        if (_partial.length() < length) return;
+        
+        encode(_partial);
+        _partial.clear();
+    }
+    
+    encode(chunk);
+}
+
+// Encodes each character as utf::to_wstring followed by utf::write would.
+void FileOutput::encode(std::string_view chunk) {
+    for (size_t i = 0; i < chunk.length(); ) {
+        auto byte1 = static_cast<uint8_t>(chunk[i]);
+        
+        if ((byte1 & 0b10000000) == 0) {
+            size_t length = utf::ascii_length(chunk.substr(i));
+            widen(chunk.substr(i, length));
+            i += length;
+            continue;
+        }
+        
+        size_t length;
+        if ((byte1 & 0b11100000) == 0b11000000) {
+            length = 2;
+        } else if ((byte1 & 0b11110000) == 0b11100000) {
+            length = 3;
+        } else {
+            // Invalid or unsupported UTF-8 sequence
+            i += 1;
+            continue;
+        }
+        
+        if (i + length > chunk.length()) {
+            _partial.assign(chunk.substr(i));
+            return;
+        }
+        
+        uint16_t utf16;
+        if (length == 2) {
+            // 2-byte UTF-8: 110xxxxx 10xxxxxx
+            utf16 = ((byte1 & 0b00011111) << 6) | (chunk[i + 1] & 0b00111111);
+        } else {
+            // 3-byte UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
+            utf16 = ((byte1 & 0b00001111) << 12) | ((chunk[i + 1] & 0b00111111) << 6) | (chunk[i + 2] & 0b00111111);
+        }
+        
+        if (!_started) put(char(0xFF), char(0xFE));
+        put(utf16 & 0xFF, utf16 >> 8);
+        i += length;
+    }
+}
+
+// Widens a run of ASCII straight into the buffer, less its carriage returns.
+void FileOutput::widen(std::string_view ascii) {
+    if (!_started) put(char(0xFF), char(0xFE));
+    
+    while (!ascii.empty()) {
+        size_t end = std::min(ascii.find('\r'), ascii.length());
+        std::string_view line = ascii.substr(0, end);
+        
+        while (!line.empty()) {
+            if (_used + 2 > _buffer.size()) flush();
+            size_t length = std::min(line.length(), (_buffer.size() - _used) / 2);
+            _used += utf::encode_utf16le(line.substr(0, length), _buffer.data() + _used);
+            line.remove_prefix(length);
+        }
+        
+        ascii.remove_prefix(std::min(end + 1, ascii.length()));
+    }
+}
+
+void FileOutput::put(const char lo, const char hi) {
+    if (_used + 2 > _buffer.size()) flush();
+    _buffer[_used++] = lo;
+    _buffer[_used++] = hi;
+    _started = true;
+}
+
+void FileOutput::flush(void) {
+    Profiler::Scope scope(Profiler::Stage::Write);
+    
+    const char *data = _buffer.data();
+    size_t length = _used;
+    _used = 0;
+    
+    while (length && !_failed) {
+#if defined(_WIN32)
+        int written = _write(_fd, data, static_cast<unsigned>(length));
+#else
+        ssize_t written = ::write(_fd, data, length);
+        if (written < 0 && errno == EINTR) continue;
+#endif
+        if (written <= 0) {
+            _failed = true;
+            break;
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+void FileOutput::close(void) {
+    // A sequence still split is cut short, as utf::to_wstring leaves one at the end.
+    _partial.clear();
+    if (_fd >= 0) flush();
+}
+
+bool FileOutput::commit(void) {
+    if (_fd < 0) return false;
+    
+    close();
+    if (!_owned) return !_failed;
+
+#if defined(_WIN32)
+    bool closed = _close(_fd) == 0;
+#else
+    bool closed = ::close(_fd) == 0;
+#endif
+    _fd = -1;
+    
+    std::error_code ec;
+    if (_failed || !closed) {
+        fs::remove(_temporary, ec);
+        return false;
+    }
+    
+    fs::rename(_temporary, _path, ec);
+    if (ec) {
+        fs::remove(_temporary, ec);
+        return false;
+    }
+    return true;
+}
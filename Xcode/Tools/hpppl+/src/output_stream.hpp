@@ -0,0 +1,134 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+namespace hppplplus {
+    /*
+     Where translated PPL goes, a chunk at a time as it is produced rather than as one
+     string at the end. A chunk may end anywhere, even part way through a character.
+     */
+    class OutputStream {
+    public:
+        virtual ~OutputStream() = default;
+        
+        virtual void write(std::string_view chunk) = 0;
+        
+        // Passes on anything held back, once the last chunk has been written.
+        virtual void close(void) {}
+    };
+    
+    // Collects the chunks, for output that is wanted whole.
+    class StringOutput : public OutputStream {
+    public:
+        void write(std::string_view chunk) override {
+            _text.append(chunk);
+        }
+        
+        std::string &text(void) {
+            return _text;
+        }
+    
+    private:
+        std::string _text;
+    };
+    
+    /*
+     Removes `uses` clauses and collapses runs of blank lines, as passes over the whole
+     translation once did, on each chunk as it comes.
+     
+     A clause ends at the first `;` after it, so only the text after the last `;`
+     written is held back, along with any run of newlines it ends with.
+     */
+    class PostPasses : public OutputStream {
+    public:
+        explicit PostPasses(OutputStream &next) : _next(next) {}
+        
+        void write(std::string_view chunk) override;
+        void close(void) override;
+    
+    private:
+        OutputStream &_next;
+        std::string _pending;       // text not yet known to be free of an unfinished clause
+        std::string _collapsed;
+        size_t _newlines = 0;       // newlines held back, as more may follow
+        
+        void collapse(std::string_view text);
+    };
+    
+    /*
+     Writes to a file, or to standard output, through a buffer of fixed size, either as
+     is or encoded as the UTF-16LE the calculator reads, with a byte order mark and no
+     carriage returns. Characters outside the BMP are dropped, as utf::to_wstring does.
+     
+     A file is written beside its path, and only takes its place once committed, so a
+     translation that fails part way leaves any earlier output untouched.
+     */
+    class FileOutput : public OutputStream {
+    public:
+        enum class Encoding {
+            UTF8,
+            UTF16LE
+        };
+        
+        // Standard output.
+        explicit FileOutput(const Encoding encoding);
+        FileOutput(const std::filesystem::path &path, const Encoding encoding);
+        ~FileOutput();
+        
+        FileOutput(const FileOutput&) = delete;
+        FileOutput& operator=(const FileOutput&) = delete;
+        
+        bool isOpen(void) const {
+            return _fd >= 0;
+        }
+        
+        void write(std::string_view chunk) override;
+        void close(void) override;
+        
+        // Closes the file and moves it into place, returning false if any of it could not be written.
+        bool commit(void);
+    
+    private:
+        int _fd = -1;
+        bool _owned = false;
+        bool _failed = false;
+        Encoding _encoding;
+        bool _started = false;      // whether the byte order mark has been written
+        std::filesystem::path _path;
+        std::filesystem::path _temporary;
+        
+        std::vector<char> _buffer;
+        size_t _used = 0;
+        std::string _partial;       // the start of a UTF-8 sequence that the last chunk split
+        
+        void encode(std::string_view chunk);
+        void widen(std::string_view ascii);
+        void put(const char lo, const char hi);
+        void flush(void);
+    };
+}
@@ -23,7 +23,7 @@
 #pragma once
 
 #include "aliases.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 #include "strings.hpp"
 #include "reformat.hpp"
 
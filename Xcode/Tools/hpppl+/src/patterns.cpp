@@ -0,0 +1,70 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "patterns.hpp"
+
+using hppplplus::Patterns;
+
+static constexpr auto icase = std::regex_constants::icase;
+
+const Patterns &Patterns::shared() {
+    static const Patterns patterns;
+    return patterns;
+}
+
+Patterns::Patterns() :
+    define(R"(^ *\{\$DEFINE +([a-z\d_]+)\})", icase),
+    undef(R"(^ *\{\$UNDEF +([a-z\d_]+)\})", icase),
+    ifdef(R"(^ *\{\$IFDEF +([a-z\d_]+) *\} *$)", icase),
+    ifndef(R"(^ *\{\$IFNDEF +([a-z\d_]+) *\} *$)", icase),
+    elseDirective(R"(^ *\{\$ELSE\} *$)", icase),
+    endifDirective(R"(^ *\{\$ENDIF\} *$)", icase),
+    once(R"(^ *\{\$ONCE\} *$)", icase),
+    include(R"(\{\$(?:INCLUDE|I) +[\w \-_~,;\[\]\(\).']+ *\})", icase),
+    includePath(R"(\{\$(?:INCLUDE|I) +([\w \-_~,;\[\]\(\).']+) *\})", icase),
+    includeMacro(R"(\{\$(?:I|INCLUDE)\s+\%(SCOPE|LINE|COUNTER|RESET|COUNT)\%\s*\})", icase),
+    addon(R"(^ *\{\$ADDON +([\w \-_~,;\[\]\(\).']+)(\.[a-z0-9]{1,10}) *\} *$)", icase),
+    unit(R"(^ *unit +([\w \-_~,;\[\]\(\).']+) *$)", icase),
+
+    regex(R"(^ *\bregex +([@<>=≠≤≥~])?`([^`]*)`(i)? *(.*)$)", icase),
+    alias(R"(\balias\b *(@)?([a-z_]\w*(?:::[a-z]\w*)*) *:= *([^\r\n\t\f\v ]+) *;)", icase),
+    pythonAlias(R"(^ *alias +([A-Za-z_]\w*) *as *([a-zA-Z][\w\[\]]*) *$)"),
+    dictionary(R"(\bdictionary +([^\r\n\t\f\v@]+) +(@)?\b([a-z_]\w*(?:::[a-z_]\w*)*);)", icase),
+    dictionaryEntry(R"(([a-z_]\w*)([^\r\n\t\f\v ,:=]+)?(?: *:= *([^\r\n\t\f\v ,]+))?)", icase),
+    uses(R"(\buses\s+([^;]+);)", icase),
+
+    codeStack(R"(__PUSH__`([^`]*)`|__POP__|__TOP__)"),
+    loop(R"(\bloop\b)", icase),
+    key(R"(^ *(KS?A?_[A-Z\d][a-z]*) *$)"),
+    base(R"(#(-)?(\d+)([bodh])\((0x[[:xdigit:]]+|[[:xdigit:]]+(?:\.[[:xdigit:]]+)?|0[0-7]+|0b[0-1]+)\))"),
+    pragmaFunction(R"(([a-zA-Z]\w*)\(([^()]*)\))"),
+
+    calc(R"(\\`([^`]+)`(?::(?:(-)?(\d+)([bodh])?|([fcr])))?)"),
+    expression(R"([\d+\-*\/ πe%&|()]+)"),
+    term(R"([^ ]+)"),
+    integer(R"(#([\dA-F]+)(?::(-)?(6[0-4]|[1-5][0-9]|[1-9]))?([odh])?)"),
+    integerNumber(R"(#([\dA-F])+(?::-?\d+)?([odh])?)"),
+    euler(R"(e)"),
+    pi(R"(π|pi)"),
+    piSymbol(R"(π)")
+{
+}
@@ -0,0 +1,86 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <regex>
+
+namespace hppplplus {
+    /*
+     The built-in regular expressions of the pre-processor.
+     
+     Constructing a std::regex compiles its pattern, which costs far more than most of
+     the searches it is then used for. Every fixed pattern is instead compiled once,
+     the first time the registry is used, and shared by all modules for the life of
+     the process.
+     */
+    class Patterns {
+    public:
+        // MARK: - Directives
+        
+        const std::regex define;            // {$DEFINE NAME}
+        const std::regex undef;             // {$UNDEF NAME}
+        const std::regex ifdef;             // {$IFDEF NAME}
+        const std::regex ifndef;            // {$IFNDEF NAME}
+        const std::regex elseDirective;     // {$ELSE}
+        const std::regex endifDirective;    // {$ENDIF}
+        const std::regex once;              // {$ONCE}
+        const std::regex include;           // {$INCLUDE path} or {$I path}
+        const std::regex includePath;       // as include, capturing the path
+        const std::regex includeMacro;      // {$I %SCOPE%} and friends, within a regex replacement
+        const std::regex addon;             // {$ADDON command.ext}
+        const std::regex unit;              // unit name
+        
+        // MARK: - Definitions
+        
+        const std::regex regex;             // regex `pattern` replacement
+        const std::regex alias;             // alias name := real;
+        const std::regex pythonAlias;       // alias name as real
+        const std::regex dictionary;        // dictionary entries name;
+        const std::regex dictionaryEntry;   // a single entry of a dictionary
+        const std::regex uses;              // uses units;
+        
+        // MARK: - Translation
+        
+        const std::regex codeStack;         // __PUSH__`code`, __POP__ and __TOP__
+        const std::regex loop;              // loop
+        const std::regex key;               // a KEY handler name on its own
+        const std::regex base;              // #[-]<bits><base>(<number>)
+        const std::regex pragmaFunction;    // name(value) within a #pragma mode
+        
+        // MARK: - Calc
+        
+        const std::regex calc;              // \`expression`[:scale]
+        const std::regex expression;        // the characters a math expression may contain
+        const std::regex term;              // a space separated term of an expression
+        const std::regex integer;           // a PPL-style integer number, capturing its parts
+        const std::regex integerNumber;     // a PPL-style integer number
+        const std::regex euler;             // e
+        const std::regex pi;                // π or pi
+        const std::regex piSymbol;          // π
+        
+        static const Patterns &shared();
+        
+    private:
+        Patterns();
+    };
+}
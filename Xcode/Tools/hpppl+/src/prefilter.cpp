@@ -0,0 +1,289 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "prefilter.hpp"
+
+#include <cctype>
+#include <algorithm>
+
+using hppplplus::Prefilter;
+
+static std::string lowercased(const std::string &str) {
+    std::string s = str;
+    for (auto &c : s) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return s;
+}
+
+/*
+ Skips over a bracketed character class, `pos` being at the opening `[`.
+ Returns the position just after the closing `]`.
+ */
+static size_t skipClass(const std::string &pattern, size_t pos) {
+    ++pos;
+    if (pos < pattern.size() && pattern[pos] == '^') ++pos;
+    if (pos < pattern.size() && pattern[pos] == ']') ++pos;
+    
+    while (pos < pattern.size() && pattern[pos] != ']') {
+        if (pattern[pos] == '\\') ++pos;
+        ++pos;
+    }
+    return pos + 1;
+}
+
+/*
+ Skips over a parenthesised group, `pos` being at the opening `(`.
+ Returns the position just after the matching `)`.
+ */
+static size_t skipGroup(const std::string &pattern, size_t pos) {
+    int depth = 0;
+    
+    while (pos < pattern.size()) {
+        switch (pattern[pos]) {
+            case '\\':
+                pos += 2;
+                continue;
+                
+            case '[':
+                pos = skipClass(pattern, pos);
+                continue;
+                
+            case '(':
+                depth++;
+                break;
+                
+            case ')':
+                if (--depth == 0) return pos + 1;
+                break;
+                
+            default:
+                break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+/*
+ Parses the quantifier, if any, at `pos`. On return `pos` is just after the
+ quantifier and `minimum` holds the least number of repetitions it allows.
+ Returns false if `{` at `pos` is not a well formed quantifier.
+ */
+static bool parseQuantifier(const std::string &pattern, size_t &pos, size_t &minimum) {
+    minimum = 1;
+    if (pos >= pattern.size()) return true;
+    
+    switch (pattern[pos]) {
+        case '*':
+        case '?':
+            minimum = 0;
+            ++pos;
+            break;
+            
+        case '+':
+            ++pos;
+            break;
+            
+        case '{': {
+            size_t end = pos + 1;
+            size_t digits = 0;
+            minimum = 0;
+            while (end < pattern.size() && isdigit(static_cast<unsigned char>(pattern[end]))) {
+                minimum = minimum * 10 + (pattern[end++] - '0');
+                digits++;
+            }
+            if (digits == 0) return false;
+            if (end < pattern.size() && pattern[end] == ',') {
+                ++end;
+                while (end < pattern.size() && isdigit(static_cast<unsigned char>(pattern[end]))) ++end;
+            }
+            if (end >= pattern.size() || pattern[end] != '}') return false;
+            pos = end + 1;
+            break;
+        }
+            
+        default:
+            return true;
+    }
+    
+    // Lazy quantifier
+    if (pos < pattern.size() && pattern[pos] == '?') ++pos;
+    return true;
+}
+
+/*
+ Extracts the longest run of literal characters that must appear in any text matched
+ by the given ECMAScript pattern. Anything not understood ends the current run, and an
+ alternation at the top level means nothing is required, so an empty string is always
+ a safe answer.
+ */
+std::string Prefilter::requiredLiteral(const std::string &pattern) {
+    std::string longest;
+    std::string run;
+    size_t pos = 0;
+    
+    auto endRun = [&longest, &run]() {
+        if (run.length() > longest.length()) longest = run;
+        run.clear();
+    };
+    
+    while (pos < pattern.size()) {
+        const char c = pattern[pos];
+        bool literal = false;
+        char character = c;
+        
+        switch (c) {
+            case '|':
+                // Top level alternation, no single literal is required.
+                return "";
+                
+            case '(':
+                pos = skipGroup(pattern, pos);
+                endRun();
+                break;
+                
+            case '[':
+                pos = skipClass(pattern, pos);
+                endRun();
+                break;
+                
+            case '.':
+            case '^':
+            case '$':
+                ++pos;
+                endRun();
+                break;
+                
+            case '*':
+            case '+':
+            case '?':
+            case '{':
+            case ')':
+            case ']':
+            case '}':
+                // Unexpected in this position, give up.
+                return "";
+                
+            case '\\': {
+                if (pos + 1 >= pattern.size()) return "";
+                const char e = pattern[pos + 1];
+                pos += 2;
+                
+                if (!isalnum(static_cast<unsigned char>(e))) {
+                    literal = true;
+                    character = e;
+                    break;
+                }
+                
+                // Character class, assertion, control or backreference escapes.
+                if (e == 'x') pos += 2;
+                if (e == 'u') pos += 4;
+                if (e == 'c') pos += 1;
+                if (isdigit(static_cast<unsigned char>(e))) {
+                    while (pos < pattern.size() && isdigit(static_cast<unsigned char>(pattern[pos]))) ++pos;
+                }
+                endRun();
+                break;
+            }
+                
+            default:
+                literal = true;
+                ++pos;
+                break;
+        }
+        
+        size_t quantifier = pos;
+        size_t minimum;
+        if (!parseQuantifier(pattern, pos, minimum)) return "";
+        
+        if (!literal) {
+            continue;
+        }
+        
+        if (minimum == 0) {
+            endRun();
+            continue;
+        }
+        
+        run += character;
+        
+        // A repeated character is required, but whatever follows is no longer adjacent to it.
+        if (pos != quantifier) {
+            endRun();
+        }
+    }
+    endRun();
+    
+    return longest;
+}
+
+void Prefilter::insert(const size_t id, const std::string &pattern) {
+    std::string literal = lowercased(requiredLiteral(pattern));
+    
+    if (id >= _keyOf.size()) _keyOf.resize(id + 1, Absent);
+    if (_keyOf[id] != Absent) erase(id);
+    
+    if (literal.empty()) {
+        _keyOf[id] = Unfiltered;
+        _unfiltered.push_back(id);
+        return;
+    }
+    
+    auto it = _keys.find(literal);
+    if (it == _keys.end()) {
+        it = _keys.emplace(literal, _automaton.insert(literal)).first;
+        _patterns.emplace_back();
+    }
+    
+    _keyOf[id] = static_cast<int>(it->second);
+    _patterns[it->second].push_back(id);
+}
+
+void Prefilter::erase(const size_t id) {
+    if (id >= _keyOf.size() || _keyOf[id] == Absent) return;
+    
+    // The literal is left within the automaton, a key no longer required by any pattern costs nothing.
+    auto &ids = _keyOf[id] == Unfiltered ? _unfiltered : _patterns[_keyOf[id]];
+    ids.erase(std::find(ids.begin(), ids.end(), id));
+    _keyOf[id] = Absent;
+}
+
+void Prefilter::clear(void) {
+    _keyOf.clear();
+    _patterns.clear();
+    _unfiltered.clear();
+    _keys.clear();
+    _automaton.clear();
+}
+
+std::vector<bool> Prefilter::candidates(const std::string &str) {
+    std::vector<bool> flags(_keyOf.size(), false);
+    
+    for (const size_t id : _unfiltered) flags[id] = true;
+    
+    _automaton.scan(lowercased(str), [this, &flags](size_t, size_t key) {
+        for (const size_t id : _patterns[key]) flags[id] = true;
+    });
+    
+    return flags;
+}
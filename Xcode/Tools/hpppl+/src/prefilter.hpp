@@ -0,0 +1,72 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "aho_corasick.hpp"
+
+namespace hppplplus {
+    /*
+     A literal prefilter for a table of regular expressions.
+     
+     When a pattern is inserted, the longest run of literal characters that every
+     match of the pattern must contain is extracted from it. A single scan of a line
+     for all those literals then tells which patterns could possibly match, so only
+     those need to be run through the real regular expression. Patterns for which no
+     required literal could be determined are always candidates.
+     
+     Literals are matched case-insensitively, which only ever makes the prefilter
+     select more candidates, never fewer.
+     */
+    class Prefilter {
+    public:
+        static std::string requiredLiteral(const std::string &pattern);
+        
+        /*
+         Patterns are identified by the caller, ids being expected to be small and
+         dense as they index the flags returned by `candidates`.
+         */
+        void insert(const size_t id, const std::string &pattern);
+        void erase(const size_t id);
+        void clear(void);
+        
+        /*
+         Returns a flag per id, set when the pattern inserted with that id could
+         match somewhere within the given text.
+         */
+        std::vector<bool> candidates(const std::string &str);
+        
+    private:
+        static constexpr int Absent = -2;
+        static constexpr int Unfiltered = -1;
+        
+        std::vector<int> _keyOf;                    // automaton key required by each id, or Absent/Unfiltered
+        std::vector<std::vector<size_t>> _patterns; // ids requiring each key of the automaton
+        std::vector<size_t> _unfiltered;            // ids with no required literal
+        std::unordered_map<std::string, size_t> _keys;
+        AhoCorasick _automaton;
+    };
+}
@@ -0,0 +1,132 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler.hpp"
+
+#include <iomanip>
+
+using hppplplus::Profiler;
+
+// The innermost stage being timed on this thread.
+static thread_local Profiler::Scope *_current = nullptr;
+
+Profiler &Profiler::shared() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Scope::Scope(const Stage stage) : _stage(stage), _active(Profiler::shared().enabled) {
+    if (!_active) return;
+    
+    _parent = _current;
+    _current = this;
+    _start = std::chrono::steady_clock::now();
+}
+
+Profiler::Scope::~Scope() {
+    if (!_active) return;
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+    Profiler &profiler = Profiler::shared();
+    
+    TStage &stage = profiler._stages[static_cast<size_t>(_stage)];
+    stage.time += elapsed - _nested;
+    stage.calls++;
+    
+    if (_parent) _parent->_nested += elapsed;
+    _current = _parent;
+}
+
+const char *Profiler::name(const size_t stage) {
+    static const char *names[_count] = {
+        "loading",
+        "directives",
+        "lexing",
+        "regex rules",
+        "escapes",
+        "operators",
+        "unary minus",
+        "aliases",
+        "code stack",
+        "dictionary",
+        "loop",
+        "keywords",
+        "alias definitions",
+        "scopes",
+        "key",
+        "calc",
+        "base",
+        "include",
+        "restore strings",
+        "post-passes",
+        "minify",
+        "reformat",
+        "write"
+    };
+    return names[stage];
+}
+
+void Profiler::report(std::ostream &os, const long long elapsed) const {
+    auto flags = os.flags();
+    auto precision = os.precision();
+    
+    os << "\n" << std::left << std::setw(20) << "Stage" << std::right << std::setw(10) << "Calls" << std::setw(14) << "Time (ms)" << std::setw(8) << "%" << "\n";
+    os << std::string(52, '-') << "\n";
+    
+    long long total = 0;
+    for (size_t i = 0; i < _count; ++i) {
+        const TStage &stage = _stages[i];
+        total += stage.time;
+        if (stage.calls == 0) continue;
+        
+        os << std::left << std::setw(20) << name(i) << std::right
+           << std::setw(10) << stage.calls
+           << std::setw(14) << std::fixed << std::setprecision(3) << stage.time / 1e6
+           << std::setw(8) << std::setprecision(1) << (elapsed > 0 ? stage.time * 100.0 / elapsed : 0.0) << "\n";
+    }
+    
+    os << std::string(52, '-') << "\n";
+    os << std::left << std::setw(20) << "other" << std::right << std::setw(10) << ""
+       << std::setw(14) << std::setprecision(3) << (elapsed - total) / 1e6
+       << std::setw(8) << std::setprecision(1) << (elapsed > 0 ? (elapsed - total) * 100.0 / elapsed : 0.0) << "\n";
+    os << std::left << std::setw(20) << "total" << std::right << std::setw(10) << ""
+       << std::setw(14) << std::setprecision(3) << elapsed / 1e6 << "\n\n";
+    
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void Profiler::reportJSON(std::ostream &os, const long long elapsed) const {
+    os << "{\n  \"elapsed_ns\": " << elapsed << ",\n  \"stages\": [";
+    
+    bool first = true;
+    for (size_t i = 0; i < _count; ++i) {
+        const TStage &stage = _stages[i];
+        if (stage.calls == 0) continue;
+        
+        os << (first ? "\n" : ",\n")
+           << "    {\"stage\": \"" << name(i) << "\", \"calls\": " << stage.calls << ", \"time_ns\": " << stage.time << "}";
+        first = false;
+    }
+    
+    os << "\n  ]\n}\n";
+}
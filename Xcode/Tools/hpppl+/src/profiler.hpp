@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+namespace hppplplus {
+    /*
+     Accumulates the time spent in, and the number of calls to, each stage of the
+     pre-processing pipeline.
+     
+     A stage is timed by a `Scope` for as long as it lives. Time spent in a stage
+     nested within another, such as the translation of an included file within the
+     include stage, is counted only toward the innermost stage. When not enabled a
+     `Scope` does nothing beyond testing the flag.
+     
+     Stages are nested per thread, and the times of files built at once on separate
+     threads add up, so their total can exceed the time elapsed.
+     */
+    class Profiler {
+    public:
+        enum class Stage {
+            Loading,
+            Directives,
+            Lexing,
+            RegexRules,
+            Escapes,
+            Operators,
+            UnaryMinus,
+            Aliases,
+            CodeStack,
+            Dictionary,
+            Loop,
+            Keywords,
+            AliasDefinitions,
+            Scopes,
+            Key,
+            Calc,
+            Base,
+            Include,
+            RestoreStrings,
+            PostPasses,
+            Minify,
+            Reformat,
+            Write
+        };
+        
+        class Scope {
+        public:
+            Scope(const Stage stage);
+            ~Scope();
+            
+        private:
+            Stage _stage;
+            bool _active;
+            std::chrono::steady_clock::time_point _start;
+            long long _nested = 0;
+            Scope *_parent = nullptr;
+        };
+        
+        bool enabled = false;
+        
+        static Profiler &shared();
+        
+        /*
+         Writes the report as a table, or as JSON, given the total elapsed time in
+         nanoseconds that the stages are a part of.
+         */
+        void report(std::ostream &os, const long long elapsed) const;
+        void reportJSON(std::ostream &os, const long long elapsed) const;
+        
+    private:
+        static constexpr size_t _count = static_cast<size_t>(Stage::Write) + 1;
+        
+        typedef struct TStage {
+            std::atomic<long long> time = 0;     // nanoseconds spent within the stage itself
+            std::atomic<long long> calls = 0;
+        } TStage;
+        
+        std::array<TStage, _count> _stages;
+        
+        static const char *name(const size_t stage);
+    };
+}
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "project.hpp"
+#include "json.hpp"
+#include "tool.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+using hppplplus::Project;
+
+namespace fs = std::filesystem;
+
+std::optional<Project> Project::load(const fs::path &path) {
+    std::ifstream infile(path, std::ios::in | std::ios::binary);
+    if (!infile.is_open()) return std::nullopt;
+    
+    std::ostringstream contents;
+    contents << infile.rdbuf();
+    
+    auto settings = json::parse(contents.str());
+    if (!settings) return std::nullopt;
+    
+    Project project;
+    project.path = fs::absolute(path).lexically_normal();
+    project.name = path.stem().string();
+    
+    for (const auto &setting : *settings) {
+        if (setting.first == "language") project.language = setting.second.string;
+        if (setting.first == "compression") project.compression = setting.second.boolean;
+        if (setting.first == "includeProgramName") project.includeProgramName = setting.second.boolean;
+        if (setting.first == "plainFallbackText") project.plainFallbackText = setting.second.boolean;
+        if (setting.first == "include") project.include = setting.second.string;
+        if (setting.first == "lib") project.lib = setting.second.string;
+    }
+    
+    return project;
+}
+
+fs::path Project::sdkRoot(void) {
+    const char *root = getenv("SDKROOT");
+    if (root && *root) return fs::path(root);
+    
+    return fs::path(tool::executableDir()).parent_path();
+}
+
+fs::path Project::directory(void) const {
+    return path.parent_path();
+}
+
+fs::path Project::resolve(const std::string &setting) const {
+    static const std::string variable = "$(SDKROOT)";
+    std::string str = setting;
+    
+    for (size_t pos = str.find(variable); pos != std::string::npos; pos = str.find(variable, pos)) {
+        std::string root = sdkRoot().string();
+        str.replace(pos, variable.length(), root);
+        pos += root.length();
+    }
+    
+    return (directory() / str).lexically_normal();
+}
+
+bool Project::isApplication(void) const {
+    return fs::is_directory(directory() / (name + ".hpappdir"));
+}
+
+fs::path Project::source(void) const {
+    std::vector<std::string> extensions = {".hppplplus", ".hpppl+", ".hpppl"};
+    
+    // A project written in plain PPL prefers main.hpppl, should there also be a main.hppplplus.
+    if (language == "hpppl") std::rotate(extensions.begin(), extensions.begin() + 2, extensions.end());
+    
+    for (const auto &extension : extensions) {
+        auto source = directory() / ("main" + extension);
+        if (fs::exists(source)) return source;
+    }
+    return directory() / "main.hppplplus";
+}
+
+fs::path Project::program(void) const {
+    if (isApplication()) return directory() / (name + ".hpappdir") / (name + ".hpappprgm");
+    
+    return directory() / (name + ".hpprgm");
+}
+
+fs::path Project::note(void) const {
+    return directory() / "info.note";
+}
+
+fs::path Project::builtNote(void) const {
+    if (isApplication()) return directory() / (name + ".hpappdir") / (name + ".hpappnote");
+    
+    return directory() / (name + ".hpnote");
+}
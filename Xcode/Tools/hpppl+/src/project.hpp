@@ -0,0 +1,74 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace hppplplus {
+    /*
+     An Xprime project, as described by its .xprimeproj file, which sits alongside the
+     main source of the program or application it builds.
+     */
+    class Project {
+    public:
+        std::filesystem::path path;     // the .xprimeproj file
+        std::string name;               // the name of the program or application
+        std::string language;
+        bool compression = false;
+        bool includeProgramName = false;
+        bool plainFallbackText = false;
+        std::string include;            // the include directory, as written in the project
+        std::string lib;                // the regular expression library directory, as written
+        
+        /*
+         The root of the SDK that `$(SDKROOT)` in a project stands for, as given by the
+         SDKROOT environment variable, or else the directory above the one hpppl+ is in.
+         */
+        static std::filesystem::path sdkRoot(void);
+        
+        // Returns nothing when the file cannot be read or is not a project.
+        static std::optional<Project> load(const std::filesystem::path &path);
+        
+        std::filesystem::path directory(void) const;
+        
+        // A setting naming a path with `$(SDKROOT)` expanded, taken relative to the project directory.
+        std::filesystem::path resolve(const std::string &setting) const;
+        
+        // Whether the project builds an application, rather than a program, having a .hpappdir.
+        bool isApplication(void) const;
+        
+        // The main source, main.hppplplus, main.hpppl+ or main.hpppl.
+        std::filesystem::path source(void) const;
+        
+        // The program built, inside the .hpappdir for an application.
+        std::filesystem::path program(void) const;
+        
+        // The note of the project, info.note, whether or not it has one.
+        std::filesystem::path note(void) const;
+        
+        // The note built, the .hpappnote of an application or the .hpnote of a program.
+        std::filesystem::path builtNote(void) const;
+    };
+}
@@ -22,25 +22,63 @@
 
 #include "regexp.hpp"
 #include "common.hpp"
-#include "singleton.hpp"
+#include "translation_context.hpp"
 #include "calc.hpp"
+#include "patterns.hpp"
+#include "strings.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
 //#include <unicode/uregex.h>
 
 using hppplplus::Regexp;
+using hppplplus::Patterns;
+
+/*
+ Every pattern compiled so far, shared by all translations, so a rule defined again,
+ by another build in server mode or another file of a batch, is not compiled again.
+ Throws std::regex_error for a pattern that is not valid.
+ */
+static std::regex compiled(const std::string &pattern, const bool insensitive) {
+    static std::map<std::pair<std::string, bool>, std::regex> patterns;
+    static std::mutex mutex;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = patterns.find({pattern, insensitive});
+        if (it != patterns.end()) return it->second;
+    }
+    
+    std::regex re(pattern, insensitive ? std::regex_constants::icase : std::regex_constants::ECMAScript);
+    std::lock_guard<std::mutex> lock(mutex);
+    return patterns.try_emplace({pattern, insensitive}, std::move(re)).first->second;
+}
+
+static Regexp::Compare compareFromString(const std::string &compare) {
+    if (compare == "<") return Regexp::Compare::Less;
+    if (compare == ">") return Regexp::Compare::Greater;
+    if (compare == "=") return Regexp::Compare::Equal;
+    if (compare == "≠") return Regexp::Compare::NotEqual;
+    if (compare == "≤") return Regexp::Compare::LessOrEqual;
+    if (compare == "≥") return Regexp::Compare::GreaterOrEqual;
+    return Regexp::Compare::Always;
+}
 
 bool Regexp::parse(const std::string &str) {
-    std::regex re;
     std::smatch match;
     
-    re = std::regex(R"(^ *\bregex +([@<>=≠≤≥~])?`([^`]*)`(i)? *(.*)$)", std::regex_constants::icase);
-    if (regex_search(str, match, re)) {
+    if (!containsIgnoringCase(str, "regex")) return false;
+    
+    if (regex_search(str, match, Patterns::shared().regex)) {
         TRegexp regexp = {
             .pattern = match[2].str(),
             .replacement = match[4].str(),
             .insensitive = match[3].matched,
-            .scopeLevel = static_cast<size_t>(Singleton::shared()->scopeDepth),
-            .line = Singleton::shared()->currentLineNumber(),
-            .path = Singleton::shared()->currentSourceFilePath()
+            .scopeLevel = static_cast<size_t>(_context.scopeDepth),
+            .line = _context.currentLineNumber(),
+            .path = _context.currentSourceFilePath()
         };
         
         if (match[1].matched) {
@@ -59,11 +97,31 @@ bool Regexp::parse(const std::string &str) {
         
         if (regularExpressionExists(regexp.pattern, regexp.compare)) return true;
         
-        _regexps.push_back(regexp);
-        if (verbose) std::cerr
+        try {
+            regexp.re = compiled(regexp.pattern, regexp.insensitive);
+        } catch (const std::regex_error &e) {
+            diagnostics() << MessageType::Error << "invalid regular expresion `" << regexp.pattern << "`, " << e.what() << "\n";
+            return true;
+        }
+        
+        size_t sequence = _sequence++;
+        regexp.slot = _regexps.size();
+        if (!_freeSlots.empty()) {
+            regexp.slot = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        
+        if (_frames.size() <= regexp.scopeLevel) _frames.resize(regexp.scopeLevel + 1);
+        _frames[regexp.scopeLevel].push_back(sequence);
+        _definitions[{regexp.pattern, regexp.compare}] = sequence;
+        _groups[static_cast<size_t>(compareFromString(regexp.compare))].emplace(regexp.scopeLevel, sequence);
+        _prefilter.insert(regexp.slot, regexp.pattern);
+        _regexps.emplace(sequence, std::move(regexp));
+        statistics(_regexps.at(sequence));
+        if (verbose) diagnostics()
             << MessageType::Verbose
-            << "defined " << (regexp.scopeLevel ? "local " : "") << "regular expresion "
-            << "`" << regexp.pattern << "`\n";
+            << "defined " << (_regexps.at(sequence).scopeLevel ? "local " : "") << "regular expresion "
+            << "`" << _regexps.at(sequence).pattern << "`\n";
         return true;
     }
     
@@ -71,19 +129,91 @@ bool Regexp::parse(const std::string &str) {
 }
 
 void Regexp::removeAllOutOfScopeRegexps() {
-    for (auto it = _regexps.begin(); it != _regexps.end(); ++it) {
-        if (it->scopeLevel > Singleton::shared()->scopeDepth) {
-            if (verbose) std::cerr
+    const size_t scopeDepth = static_cast<size_t>(_context.scopeDepth);
+    
+    while (_frames.size() > scopeDepth + 1) {
+        const size_t scopeLevel = _frames.size() - 1;
+        
+        for (const size_t sequence : _frames.back()) {
+            const TRegexp &regexp = _regexps.at(sequence);
+            
+            if (verbose) diagnostics()
                 << MessageType::Verbose
-                << "removed " << (it->scopeLevel ? "local " : "") << "regular expresion ``\n";
+                << "removed " << (regexp.scopeLevel ? "local " : "") << "regular expresion `" << regexp.pattern << "`\n";
             
-            _regexps.erase(it);
-            removeAllOutOfScopeRegexps();
-            break;
+            _definitions.erase({regexp.pattern, regexp.compare});
+            _prefilter.erase(regexp.slot);
+            _freeSlots.push_back(regexp.slot);
+            _regexps.erase(sequence);
         }
+        
+        // Every rule of this scope level belongs to this frame.
+        for (auto &group : _groups) group.erase(scopeLevel);
+        
+        _frames.pop_back();
     }
 }
 
+/*
+ Collects, in order of definition, the sequence numbers of all the rules whose scope-comparison
+ holds at the given scope depth. Each group is keyed by scope level so the rules that
+ cannot apply are skipped as a range rather than tested one by one.
+ */
+std::vector<size_t> Regexp::applicableRegexps(const size_t scopeDepth) {
+    std::vector<size_t> indices;
+    
+    auto collect = [&indices](auto first, auto last) {
+        for (auto it = first; it != last; ++it) indices.push_back(it->second);
+    };
+    
+    for (size_t n = 0; n < _groups.size(); ++n) {
+        auto &group = _groups[n];
+        if (group.empty()) continue;
+        
+        switch (static_cast<Compare>(n)) {
+            case Compare::Always:
+                collect(group.begin(), group.end());
+                break;
+                
+            case Compare::Less:
+                // scopeDepth < scopeLevel
+                collect(group.upper_bound(scopeDepth), group.end());
+                break;
+                
+            case Compare::Greater:
+                // scopeDepth > scopeLevel
+                collect(group.begin(), group.lower_bound(scopeDepth));
+                break;
+                
+            case Compare::Equal: {
+                auto range = group.equal_range(scopeDepth);
+                collect(range.first, range.second);
+                break;
+            }
+                
+            case Compare::NotEqual: {
+                auto range = group.equal_range(scopeDepth);
+                collect(group.begin(), range.first);
+                collect(range.second, group.end());
+                break;
+            }
+                
+            case Compare::LessOrEqual:
+                // scopeDepth ≤ scopeLevel
+                collect(group.lower_bound(scopeDepth), group.end());
+                break;
+                
+            case Compare::GreaterOrEqual:
+                // scopeDepth ≥ scopeLevel
+                collect(group.begin(), group.upper_bound(scopeDepth));
+                break;
+        }
+    }
+    
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
 /*
  * Custom parser macros:
  *
@@ -102,45 +232,42 @@ void Regexp::removeAllOutOfScopeRegexps() {
  * These macros are handled by the parser during preprocessing and are not
  * part of standard C++ preprocessor behavior.
  */
-static std::string resolve(const std::string &str) {
+static std::string resolve(const std::string &str, hppplplus::TranslationContext &context) {
     std::smatch match;
     std::string::const_iterator it;
     std::string output = str;
     
-    static const std::regex re(
-                               R"(\{\$(?:I|INCLUDE)\s+\%(SCOPE|LINE|COUNTER|RESET|COUNT)\%\s*\})",
-                               std::regex_constants::icase
-                               );
+    const std::regex &re = Patterns::shared().includeMacro;
     
     it = output.cbegin();
     while (std::regex_search(it, output.cend(), match, re)) {
         if (match.str(1) == "SCOPE") {
-            output.replace(match.position(), match.length(), std::to_string(hppplplus::Singleton::shared()->scopeDepth));
+            output.replace(match.position(), match.length(), std::to_string(context.scopeDepth));
             it = output.cbegin();
             continue;
         }
         
         if (match.str(1) == "COUNTER") {
-            output.replace(match.position(), match.length(), std::to_string(hppplplus::Singleton::shared()->count));
-            hppplplus::Singleton::shared()->advanceCount();
+            output.replace(match.position(), match.length(), std::to_string(context.count));
+            context.advanceCount();
             it = output.cbegin();
             continue;
         }
         
         if (match.str(1) == "COUNT") {
-            output.replace(match.position(), match.length(), std::to_string(hppplplus::Singleton::shared()->count));
+            output.replace(match.position(), match.length(), std::to_string(context.count));
             it = output.cbegin();
             continue;
         }
         
         if (match.str(1) == "LINE") {
-            output.replace(match.position(), match.length(), std::to_string(hppplplus::Singleton::shared()->currentLineNumber()));
+            output.replace(match.position(), match.length(), std::to_string(context.currentLineNumber()));
             it = output.cbegin();
             continue;
         }
         
         if (match.str(1) == "RESET") {
-            hppplplus::Singleton::shared()->resetCount();
+            context.resetCount();
         }
         
         // Erase only the matched portion and update the iterator correctly
@@ -152,59 +279,205 @@ static std::string resolve(const std::string &str) {
 }
 
 void Regexp::applyAllRegularExpressions(std::string& str, const size_t index) {
-    std::smatch match;
-    std::regex re;
+    // index is used to prevent the function from entering a recursive loop.
     
+    auto indices = applicableRegexps(static_cast<size_t>(_context.scopeDepth));
+    if (indices.empty()) return;
     
-    // index is used to prevent the function from entering a recursive loop.
+    // Only rules whose required literal occurs within the text can possibly match.
+    auto candidates = _prefilter.candidates(str);
     
-    for (auto it = _regexps.begin(); it != _regexps.end(); ++it) {
-        if (!it->compare.empty()) {
-            auto currentScopeLevel = Singleton::shared()->scopeDepth;
-            if (it->compare == "<" && currentScopeLevel >= it->scopeLevel) continue;
-            if (it->compare == ">" && currentScopeLevel <= it->scopeLevel) continue;
-            if (it->compare == "=" && currentScopeLevel != it->scopeLevel) continue;
-            if (it->compare == "≠" && currentScopeLevel == it->scopeLevel) continue;
-            if (it->compare == "≤" && currentScopeLevel > it->scopeLevel) continue;
-            if (it->compare == "≥" && currentScopeLevel < it->scopeLevel) continue;
+    for (const size_t i : indices) {
+        const TRegexp &regexp = _regexps.at(i);
+        if (!candidates[regexp.slot]) continue;
+        
+        TStatistics *stats = profile ? &statistics(regexp) : nullptr;
+        auto start = std::chrono::steady_clock::now();
+        
+        bool found = std::regex_search(str, regexp.re);
+        if (stats) {
+            stats->attempts++;
+            if (found) stats->matches++;
         }
-        if (it->insensitive)
-            re = std::regex(it->pattern, std::regex_constants::icase);
-        else
-            re = std::regex(it->pattern);
         
-        if (std::regex_search(str, match, re)) {
-            size_t i = std::distance(_regexps.begin(), it);
-            
+        if (found) {
             // If the function encounters the same index again, it means recursion is repeating.
             // Reset prev_index and exit to stop an infinite recursive loop.
             if (index == i) {
+                if (stats) {
+                    stats->stopped++;
+                    stats->time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                }
                 return;
             }
-            str = regex_replace(str, re, it->replacement);
-            str = resolve(str);
+            str = regex_replace(str, regexp.re, regexp.replacement);
+            str = resolve(str, _context);
             Calc::evaluateMathExpression(str);
-            
+        }
+        
+        // Time spent re-applying the rules is counted against the rules that match, not this one.
+        if (stats) stats->time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        
+        if (found) {
+            if (stats) stats->recursions++;
             applyAllRegularExpressions(str, i);
+            candidates = _prefilter.candidates(str);
         }
     }
 }
 
-bool Regexp::regularExpressionExists(const std::string &pattern, const std::string &compare) {
-    for (auto it = _regexps.begin(); it != _regexps.end(); ++it) {
-        if (it->pattern == pattern && it->compare == compare) {
-            std::cerr << MessageType::Warning;
-            if (it->path.filename().empty()) {
-                std::cerr << "regular expresion already defined.\n";
-            } else {
-                std::cerr << "regular expresion already defined. previous definition at " << it->path.filename() << ":" << it->line << "\n";
+void Regexp::save(ArchiveWriter &archive, const bool locations) const {
+    std::map<size_t, const TRegexp *> ordered;
+    for (const auto &regexp : _regexps) ordered.emplace(regexp.first, &regexp.second);
+    
+    archive.write(ordered.size());
+    for (const auto &it : ordered) {
+        const TRegexp &regexp = *it.second;
+        archive.write(regexp.pattern);
+        archive.write(regexp.replacement);
+        archive.write(regexp.insensitive);
+        archive.write(regexp.scopeLevel);
+        archive.write(regexp.compare);
+        if (!locations) continue;
+        archive.write(regexp.line);
+        archive.write(regexp.path.string());
+    }
+}
+
+bool Regexp::load(ArchiveReader &archive) {
+    size_t count = 0;
+    std::vector<TRegexp> regexps;
+    
+    if (!archive.read(count)) return false;
+    for (size_t i = 0; i < count; ++i) {
+        TRegexp regexp;
+        std::string path;
+        
+        archive.read(regexp.pattern);
+        archive.read(regexp.replacement);
+        archive.read(regexp.insensitive);
+        archive.read(regexp.scopeLevel);
+        archive.read(regexp.compare);
+        archive.read(regexp.line);
+        if (!archive.read(path)) return false;
+        regexp.path = path;
+        
+        auto existing = _definitions.find({regexp.pattern, regexp.compare});
+        if (existing != _definitions.end() && _regexps.at(existing->second).insensitive == regexp.insensitive) {
+            const TRegexp &current = _regexps.at(existing->second);
+            if (current.replacement == regexp.replacement && current.scopeLevel == regexp.scopeLevel) {
+                regexp.line = current.line;
+                regexp.path = current.path;
             }
-            return true;
         }
+        try {
+            regexp.re = compiled(regexp.pattern, regexp.insensitive);
+        } catch (const std::regex_error &e) {
+            return false;
+        }
+        regexps.push_back(std::move(regexp));
     }
     
-    return false;
+    _regexps.clear();
+    _frames.clear();
+    _definitions.clear();
+    for (auto &group : _groups) group.clear();
+    _prefilter.clear();
+    _freeSlots.clear();
+    _sequence = 0;
+    
+    for (auto &regexp : regexps) {
+        size_t sequence = _sequence++;
+        regexp.slot = sequence;
+        
+        if (_frames.size() <= regexp.scopeLevel) _frames.resize(regexp.scopeLevel + 1);
+        _frames[regexp.scopeLevel].push_back(sequence);
+        _definitions[{regexp.pattern, regexp.compare}] = sequence;
+        _groups[static_cast<size_t>(compareFromString(regexp.compare))].emplace(regexp.scopeLevel, sequence);
+        _prefilter.insert(regexp.slot, regexp.pattern);
+        _regexps.emplace(sequence, std::move(regexp));
+        statistics(_regexps.at(sequence));
+    }
+    
+    return true;
 }
 
+Regexp::TStatistics &Regexp::statistics(const TRegexp &regexp) {
+    auto it = _statistics.try_emplace({regexp.path.string(), regexp.line, regexp.pattern, regexp.compare}).first;
+    if (it->second.pattern.empty()) {
+        it->second.pattern = regexp.pattern;
+        it->second.line = regexp.line;
+        it->second.path = regexp.path;
+    }
+    return it->second;
+}
 
+void Regexp::report(std::ostream &os, const size_t count) const {
+    std::vector<const TStatistics *> rules;
+    std::vector<const TStatistics *> unmatched;
+    long long attempts = 0;
+    long long time = 0;
+    
+    for (const auto &it : _statistics) {
+        const TStatistics &stats = it.second;
+        attempts += stats.attempts;
+        time += stats.time;
+        if (stats.attempts) rules.push_back(&stats);
+        if (!stats.matches) unmatched.push_back(&stats);
+    }
+    
+    std::stable_sort(rules.begin(), rules.end(), [](const TStatistics *a, const TStatistics *b) {
+        return a->time > b->time;
+    });
+    std::stable_sort(unmatched.begin(), unmatched.end(), [](const TStatistics *a, const TStatistics *b) {
+        return a->attempts > b->attempts;
+    });
+    
+    auto location = [](const TStatistics &stats) {
+        std::string name = stats.path.filename().string();
+        return (name.empty() ? std::string("command line") : name + ":" + std::to_string(stats.line));
+    };
+    
+    os << "\nRegular expressions: " << _statistics.size() << " defined, " << attempts << " attempts in "
+       << std::fixed << std::setprecision(2) << time / 1e6 << " milliseconds\n";
+    if (rules.empty()) return;
+    
+    os << "\n" << std::right
+       << std::setw(12) << "Time (ms)"
+       << std::setw(10) << "Attempts"
+       << std::setw(10) << "Matches"
+       << std::setw(10) << "Stopped"
+       << std::setw(12) << "Recursions"
+       << "  Rule\n";
+    for (size_t i = 0; i < rules.size() && i < count; ++i) {
+        const TStatistics &stats = *rules[i];
+        os << std::setw(12) << std::fixed << std::setprecision(3) << stats.time / 1e6
+           << std::setw(10) << stats.attempts
+           << std::setw(10) << stats.matches
+           << std::setw(10) << stats.stopped
+           << std::setw(12) << stats.recursions
+           << "  " << location(stats) << " `" << stats.pattern << "`\n";
+    }
+    
+    if (unmatched.empty()) return;
+    os << "\nNever matched: " << unmatched.size() << " rules\n";
+    for (size_t i = 0; i < unmatched.size() && i < count; ++i) {
+        const TStatistics &stats = *unmatched[i];
+        os << std::setw(10) << stats.attempts << " attempts  " << location(stats) << " `" << stats.pattern << "`\n";
+    }
+    if (unmatched.size() > count) os << "  ... and " << unmatched.size() - count << " more\n";
+}
 
+bool Regexp::regularExpressionExists(const std::string &pattern, const std::string &compare) {
+    auto it = _definitions.find({pattern, compare});
+    if (it == _definitions.end()) return false;
+    
+    const TRegexp &regexp = _regexps.at(it->second);
+    diagnostics() << MessageType::Warning;
+    if (regexp.path.filename().empty()) {
+        diagnostics() << "regular expresion already defined.\n";
+    } else {
+        diagnostics() << "regular expresion already defined. previous definition at " << regexp.path.filename() << ":" << regexp.line << "\n";
+    }
+    return true;
+}
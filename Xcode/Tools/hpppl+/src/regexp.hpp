@@ -24,13 +24,40 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <regex>
 #include <filesystem>
 
+#include "prefilter.hpp"
+#include "archive.hpp"
+
 namespace hppplplus {
+    class TranslationContext;
+    
     class Regexp {
     public:
         bool verbose = false;
+        bool profile = false;
+        
+        // Rules are defined, and applied, at the scope depth and location the context has reached.
+        explicit Regexp(TranslationContext &context) : _context(context) {}
+        
+        /*
+         The scope-comparison operator a rule was defined with, `Always` being
+         used for rules that have no operator and so apply at any scope depth.
+         */
+        enum class Compare {
+            Always,
+            Less,
+            Greater,
+            Equal,
+            NotEqual,
+            LessOrEqual,
+            GreaterOrEqual
+        };
         
         typedef struct TRegexp {
             std::string pattern;
@@ -41,15 +68,88 @@ namespace hppplplus {
             
             long line;              // line that definition accoured;
             std::filesystem::path path;   // path and filename that definition accoured
+            
+            std::regex re;          // pattern compiled once, when the definition is parsed
+            size_t slot = 0;        // id within the prefilter, reused once the rule is removed
         } TRegexp;
         
+        /*
+         Counts kept for each rule while profiling. A rule is attempted each time it
+         is searched for, and each of its matches either applies the rule, which
+         re-applies all the rules to the result, or is stopped as a repeat of the
+         rule that was just applied. Each such re-application is counted as a
+         recursion of the rule applied.
+         */
+        typedef struct TStatistics {
+            std::string pattern;
+            long line = 0;
+            std::filesystem::path path;
+            long long attempts = 0;
+            long long matches = 0;
+            long long stopped = 0;
+            long long recursions = 0;
+            long long time = 0;     // nanoseconds spent searching and replacing
+        } TStatistics;
+        
         bool parse(const std::string &str);
         void removeAllOutOfScopeRegexps(void);
         void applyAllRegularExpressions(std::string &str, const size_t index = -1);
         
+        /*
+         Saves every rule in order of definition. Without `locations` the line and file
+         of each definition are left out.
+         */
+        void save(ArchiveWriter &archive, const bool locations) const;
+        
+        /*
+         Replaces every rule with those of an archive saved with locations. A rule that
+         is already defined exactly as archived keeps its location and compiled pattern.
+         */
+        bool load(ArchiveReader &archive);
+        
+        // Writes the rules taking the most time, and those that never matched, to `os`.
+        void report(std::ostream &os, const size_t count) const;
+        
         
     private:
-        std::vector<TRegexp> _regexps;
+        TranslationContext &_context;
+        
+        /*
+         Rules keyed by a sequence number given in order of definition, which is
+         also the order they are applied in.
+         */
+        std::unordered_map<size_t, TRegexp> _regexps;
+        size_t _sequence = 0;
+        
+        /*
+         Prefilter slots freed by rules removed on leaving a scope. Every slot below the
+         count of rules is either in use or free, so the prefilter only ever grows to
+         the most rules defined at once, not to every rule ever defined.
+         */
+        std::vector<size_t> _freeSlots;
+        
+        /*
+         A frame per scope level holding the sequence numbers of the rules local to
+         that level, so leaving a scope drops its rules without a search.
+         */
+        std::vector<std::vector<size_t>> _frames;
+        
+        // Sequence number of each rule, keyed by its pattern and scope-comparison operator.
+        std::map<std::pair<std::string, std::string>, size_t> _definitions;
+        
+        /*
+         Sequence numbers grouped by scope-comparison operator and keyed by scope
+         level, so only the rules able to apply at the current scope depth are
+         visited.
+         */
+        std::array<std::multimap<size_t, size_t>, 7> _groups;
+        Prefilter _prefilter;
+        
+        // Kept for every rule ever defined, so a rule that went out of scope is still reported.
+        std::map<std::tuple<std::string, long, std::string, std::string>, TStatistics> _statistics;
+        
+        TStatistics &statistics(const TRegexp &regexp);
         bool regularExpressionExists(const std::string &pattern, const std::string &compare);
+        std::vector<size_t> applicableRegexps(const size_t scopeDepth);
     };
 }
@@ -0,0 +1,95 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "source_buffer.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using hppplplus::SourceBuffer;
+using hppplplus::LineReader;
+
+namespace fs = std::filesystem;
+
+// Files smaller than this are read, mapping them being slower than copying.
+static const size_t mappingThreshold = 64 * 1024;
+
+SourceBuffer::SourceBuffer(const fs::path &path) {
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && static_cast<size_t>(status.st_size) >= mappingThreshold) {
+        void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            _mapping = mapping;
+            _length = status.st_size;
+            _data = std::string_view(static_cast<const char *>(mapping), _length);
+            close(fd);
+            return;
+        }
+    }
+    close(fd);
+#endif
+    
+    std::ifstream infile(path, std::ios::in | std::ios::binary);
+    if (!infile.is_open()) return;
+    
+    std::ostringstream contents;
+    contents << infile.rdbuf();
+    _contents = contents.str();
+    _data = _contents;
+}
+
+SourceBuffer::~SourceBuffer() {
+#if !defined(_WIN32)
+    if (_mapping) munmap(_mapping, _length);
+#endif
+}
+
+utf::BOM SourceBuffer::bom(void) const {
+    if (_data.length() < 2) return utf::BOM::none;
+    
+    auto first = static_cast<unsigned char>(_data[0]), second = static_cast<unsigned char>(_data[1]);
+    if (first == 0xFF && second == 0xFE) return utf::BOM::le;
+    if (first == 0xFE && second == 0xFF) return utf::BOM::be;
+    return utf::BOM::none;
+}
+
+bool LineReader::next(std::string_view &line) {
+    if (_position >= _text.length()) return false;
+    
+    size_t end = _text.find('\n', _position);
+    if (end == std::string_view::npos) end = _text.length();
+    
+    line = _text.substr(_position, end - _position);
+    _position = end < _text.length() ? end + 1 : end;
+    return true;
+}
@@ -0,0 +1,87 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <algorithm>
+
+#include "utf.hpp"
+
+namespace hppplplus {
+    /*
+     The contents of a source file, read once. Large files are mapped into memory
+     rather than read, so loading them copies nothing; small ones are simply read, as
+     mapping costs more than it saves for them.
+     
+     A mapped file is expected not to be truncated while in use, as an editor saving
+     in place could do, since the mapped pages would then no longer be backed.
+     */
+    class SourceBuffer {
+    public:
+        explicit SourceBuffer(const std::filesystem::path &path);
+        ~SourceBuffer();
+        
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+        
+        // Every byte of the file, byte order mark and all.
+        std::string_view data(void) const {
+            return _data;
+        }
+        
+        // The byte order mark of a UTF-16 file, BOM::none for UTF-8.
+        utf::BOM bom(void) const;
+        
+    private:
+        std::string_view _data;
+        std::string _contents;      // the file as read, when not mapped
+        void *_mapping = nullptr;
+        size_t _length = 0;
+    };
+    
+    /*
+     Reads the lines of a source one after another, as std::getline would, each a view
+     into the source rather than a copy.
+     */
+    class LineReader {
+    public:
+        explicit LineReader(std::string_view text) : _text(text) {}
+        
+        // The next line, without its newline, or false once none is left.
+        bool next(std::string_view &line);
+        
+        size_t position(void) const {
+            return _position;
+        }
+        
+        void seek(size_t position) {
+            _position = std::min(position, _text.length());
+        }
+        
+    private:
+        std::string_view _text;
+        size_t _position = 0;
+    };
+}
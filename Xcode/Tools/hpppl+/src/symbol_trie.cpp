@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "symbol_trie.hpp"
+
+#include <algorithm>
+
+using hppplplus::SymbolTrie;
+
+static bool isWordCharacter(const char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Mirrors `\b`, true when the characters either side of the position differ in being word characters.
+static bool isWordBoundary(const std::string &str, const size_t position) {
+    bool before = position > 0 && isWordCharacter(str[position - 1]);
+    bool after = position < str.length() && isWordCharacter(str[position]);
+    return before != after;
+}
+
+int SymbolTrie::child(const int node, const unsigned char c) const {
+    const auto &next = _nodes[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c, [](const std::pair<unsigned char, int> &edge, const unsigned char c) {
+        return edge.first < c;
+    });
+    if (it == next.end() || it->first != c) return -1;
+    return it->second;
+}
+
+int SymbolTrie::find(const std::string &symbol) const {
+    int node = 0;
+    for (const unsigned char c : symbol) {
+        node = child(node, c);
+        if (node < 0) return -1;
+    }
+    return node;
+}
+
+void SymbolTrie::insert(const std::string &symbol, const std::string &replacement) {
+    if (symbol.empty()) return;
+    
+    int node = 0;
+    for (const unsigned char c : symbol) {
+        int next = child(node, c);
+        if (next < 0) {
+            next = static_cast<int>(_nodes.size());
+            _nodes.emplace_back();
+            auto &edges = _nodes[node].next;
+            auto it = std::lower_bound(edges.begin(), edges.end(), c, [](const std::pair<unsigned char, int> &edge, const unsigned char c) {
+                return edge.first < c;
+            });
+            edges.insert(it, {c, next});
+        }
+        node = next;
+    }
+    
+    if (!_nodes[node].terminal) _count++;
+    _nodes[node].terminal = true;
+    _nodes[node].replacement = replacement;
+}
+
+void SymbolTrie::remove(const std::string &symbol) {
+    int node = find(symbol);
+    if (node <= 0 || !_nodes[node].terminal) return;
+    
+    // The path is left in place, it costs nothing and is likely to be reused by the next local of the same name.
+    _nodes[node].terminal = false;
+    _nodes[node].replacement.clear();
+    _count--;
+}
+
+void SymbolTrie::clear(void) {
+    _nodes.assign(1, TNode());
+    _count = 0;
+}
+
+bool SymbolTrie::replaceAll(std::string &str) const {
+    if (_count == 0) return false;
+    
+    std::string result;
+    bool replaced = false;
+    size_t i = 0;
+    size_t copied = 0;
+    
+    while (i < str.length()) {
+        if (!isWordBoundary(str, i)) {
+            ++i;
+            continue;
+        }
+        
+        // Walk the trie for the longest symbol starting here that also ends on a word boundary.
+        const TNode *match = nullptr;
+        size_t end = i;
+        int node = 0;
+        for (size_t j = i; j < str.length(); ++j) {
+            node = child(node, str[j]);
+            if (node < 0) break;
+            if (_nodes[node].terminal && isWordBoundary(str, j + 1)) {
+                match = &_nodes[node];
+                end = j + 1;
+            }
+        }
+        
+        if (!match) {
+            ++i;
+            continue;
+        }
+        
+        result.append(str, copied, i - copied);
+        result.append(match->replacement);
+        copied = end;
+        i = end;
+        replaced = true;
+    }
+    
+    if (!replaced) return false;
+    
+    result.append(str, copied, std::string::npos);
+    str = std::move(result);
+    return true;
+}
@@ -0,0 +1,67 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace hppplplus {
+    /*
+     A trie of symbols, each with the text it is to be replaced with.
+     
+     Symbols are matched as whole words, with the same word boundaries as `\b`
+     in a regular expression, and at any position the longest matching symbol
+     wins. Symbols can be inserted and removed at any time without a rebuild.
+     */
+    class SymbolTrie {
+    public:
+        void insert(const std::string &symbol, const std::string &replacement);
+        void remove(const std::string &symbol);
+        void clear(void);
+        
+        bool empty(void) const {
+            return _count == 0;
+        }
+        
+        /*
+         Replaces every whole-word occurrence of every symbol within the string in
+         a single left-to-right pass. Replacement text is not itself rescanned.
+         Returns true if any replacement was made.
+         */
+        bool replaceAll(std::string &str) const;
+        
+    private:
+        typedef struct TNode {
+            std::vector<std::pair<unsigned char, int>> next;
+            bool terminal = false;
+            std::string replacement;
+        } TNode;
+        
+        std::vector<TNode> _nodes = std::vector<TNode>(1);
+        size_t _count = 0;
+        
+        int child(const int node, const unsigned char c) const;
+        int find(const std::string &symbol) const;
+    };
+}
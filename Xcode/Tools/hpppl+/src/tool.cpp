@@ -23,17 +23,25 @@
 // SOFTWARE.
 
 #include "tool.hpp"
+#include "hpppl_addon.h"
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
 
 #if defined(_WIN32)
     #include <windows.h>
+    #include <thread>
 #else
     #include <limits.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <dlfcn.h>
     #include <spawn.h>
     #include <sys/wait.h>
 #endif
@@ -48,7 +56,7 @@ extern char **environ;
 
 using namespace tool;
 
-static std::string executableDir()
+std::string tool::executableDir()
 {
 #ifdef DEBUG
     return "/usr/local/bin";
@@ -156,15 +164,17 @@ result_t tool::runTool(const std::string& command,
         return r;
     }
 
+    // Both pipes are drained while the tool runs, so it never blocks on a full one.
+    std::thread err([&] { r.err = readPipe(errRead); });
+    r.out = readPipe(outRead);
+    err.join();
+
     WaitForSingleObject(pi.hProcess, INFINITE);
 
     DWORD code;
     GetExitCodeProcess(pi.hProcess, &code);
     r.exitCode = static_cast<int>(code);
 
-    r.out = readPipe(outRead);
-    r.err = readPipe(errRead);
-
     CloseHandle(outRead);
     CloseHandle(errRead);
     CloseHandle(pi.hProcess);
@@ -175,16 +185,54 @@ result_t tool::runTool(const std::string& command,
 
 #else // POSIX
 
-static std::string readFd(int fd)
+// A pipe whose ends are not inherited by tools spawned by other threads meanwhile, which would hold it open.
+static int openPipe(int fds[2])
 {
-    std::string result;
-    char buffer[4096];
+#if defined(__linux__)
+    return pipe2(fds, O_CLOEXEC);
+#else
+    if (pipe(fds) != 0) return -1;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return 0;
+#endif
+}
 
-    ssize_t n;
-    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
-        result.append(buffer, n);
+/*
+ Reads both stdout and stderr until each is closed, whichever has data first, so a tool
+ writing a lot to one is never left blocked on it while the other is being read.
+ */
+static void drain(int outFd, int errFd, std::string& out, std::string& err)
+{
+    struct pollfd fds[2] = {
+        { outFd, POLLIN, 0 },
+        { errFd, POLLIN, 0 }
+    };
+    std::string* results[2] = { &out, &err };
+    char buffer[4096];
+    int open = 2;
+
+    while (open > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                results[i]->append(buffer, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+
+            // Closed, or failed, so no longer polled.
+            fds[i].fd = -1;
+            open--;
+        }
     }
-    return result;
 }
 
 
@@ -196,8 +244,8 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
     // Pipes for stdout and stderr
     int outPipe[2];
     int errPipe[2];
-    pipe(outPipe);
-    pipe(errPipe);
+    openPipe(outPipe);
+    openPipe(errPipe);
 
     posix_spawn_file_actions_t actions;
     posix_spawn_file_actions_init(&actions);
@@ -228,8 +276,7 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
     result_t result{};
 
     if (rc == 0) {
-        result.out = readFd(outPipe[0]);
-        result.err = readFd(errPipe[0]);
+        drain(outPipe[0], errPipe[0], result.out, result.err);
 
         int status;
         waitpid(pid, &status, 0);
@@ -251,3 +298,73 @@ result_t tool::runTool(const std::string& command, const std::vector<std::string
 
 #endif
 
+// MARK: - Plugins
+
+#if defined(__APPLE__)
+    #define PLUGIN_EXTENSION ".dylib"
+#elif defined(_WIN32)
+    #define PLUGIN_EXTENSION ".dll"
+#else
+    #define PLUGIN_EXTENSION ".so"
+#endif
+
+typedef int (*convert_t)(const char*, const char* const*, hpppl_addon_buffer*, hpppl_addon_buffer*);
+
+std::string tool::pluginPath(const std::string& command)
+{
+    return executableDir() + "/lib" + command + PLUGIN_EXTENSION;
+}
+
+// The entry point of the add-on's shared library, loaded once and kept loaded, or null if it has none.
+static convert_t plugin(const std::string& command)
+{
+    static std::unordered_map<std::string, convert_t> plugins;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = plugins.find(command);
+    if (it != plugins.end()) return it->second;
+
+    convert_t convert = nullptr;
+#if !defined(_WIN32)
+    void* handle = dlopen(pluginPath(command).c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle) {
+        auto version = reinterpret_cast<int (*)(void)>(dlsym(handle, "hpppl_addon_abi_version"));
+        if (version && version() == HPPPL_ADDON_ABI_VERSION) {
+            convert = reinterpret_cast<convert_t>(dlsym(handle, "hpppl_addon_convert"));
+        }
+        if (!convert) dlclose(handle);
+    }
+#endif
+
+    plugins[command] = convert;
+    return convert;
+}
+
+// The contents of a buffer handed back by an add-on, which is then released.
+static std::string take(hpppl_addon_buffer& buffer)
+{
+    std::string str;
+    if (buffer.data) str.assign(buffer.data, buffer.length);
+    if (buffer.release) buffer.release(&buffer);
+    return str;
+}
+
+std::optional<result_t> tool::runPlugin(const std::string& command, const std::string& path, const std::vector<std::string>& arguments)
+{
+    convert_t convert = plugin(command);
+    if (!convert) return std::nullopt;
+
+    std::vector<const char*> argv;
+    for (const auto& argument : arguments)
+        argv.push_back(argument.c_str());
+    argv.push_back(nullptr);
+
+    hpppl_addon_buffer out{}, err{};
+    result_t result{};
+    result.exitCode = convert(path.c_str(), argv.data(), &out, &err);
+    result.out = take(out);
+    result.err = take(err);
+    return result;
+}
+
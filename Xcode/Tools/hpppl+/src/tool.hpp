@@ -26,6 +26,7 @@
 
 #include <string>
 #include <vector>
+#include <optional>
 
 namespace tool {
     struct result_t {
@@ -34,5 +35,14 @@ namespace tool {
         std::string err;
     };
     
+    // The directory of the running executable, where the tools it runs are found.
+    std::string executableDir(void);
+    
     result_t runTool(const std::string& command, const std::vector<std::string>& arguments);
+    
+    // Where the add-on `command` is found when built as a shared library, see hpppl_addon.h.
+    std::string pluginPath(const std::string& command);
+    
+    // Runs the add-on `command` in-process on `path`, or returns nothing if it is not built as a shared library.
+    std::optional<result_t> runPlugin(const std::string& command, const std::string& path, const std::vector<std::string>& arguments);
 }
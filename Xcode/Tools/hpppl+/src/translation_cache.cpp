@@ -0,0 +1,276 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "translation_cache.hpp"
+#include "archive.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
+#include "../version_code.h"
+
+using hppplplus::TranslationCache;
+using hppplplus::ArchiveWriter;
+using hppplplus::ArchiveReader;
+
+namespace fs = std::filesystem;
+
+static const char *signature = "hpppl+ translation cache";
+
+static std::optional<std::string> read(const fs::path &path) {
+    std::ifstream infile(path, std::ios::in | std::ios::binary);
+    if (!infile.is_open()) return std::nullopt;
+    
+    std::ostringstream contents;
+    contents << infile.rdbuf();
+    return contents.str();
+}
+
+TranslationCache::TranslationCache() {
+    const char *cache = std::getenv("XDG_CACHE_HOME");
+    const char *home = std::getenv("HOME");
+    
+    if (cache && *cache) {
+        directory = fs::path(cache) / "hpppl+";
+    } else if (home && *home) {
+        directory = fs::path(home) / ".cache" / "hpppl+";
+    } else {
+        enabled = false;
+    }
+}
+
+// 128-bit FNV-1a, as hexadecimal.
+std::string TranslationCache::digest(std::string_view data) {
+    unsigned __int128 hash = (static_cast<unsigned __int128>(0x6c62272e07bb0142ULL) << 64) | 0x62b821756295c58dULL;
+    const unsigned __int128 prime = (static_cast<unsigned __int128>(1) << 88) | 0x13b;
+    
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= prime;
+    }
+    
+    static const char *hex = "0123456789abcdef";
+    std::string str(32, '0');
+    for (int i = 31; i >= 0; --i) {
+        str[i] = hex[static_cast<unsigned>(hash & 0xf)];
+        hash >>= 4;
+    }
+    return str;
+}
+
+std::string TranslationCache::fileDigest(const fs::path &path) {
+    auto contents = read(path);
+    if (!contents) return "-";
+    return digest(*contents);
+}
+
+std::string TranslationCache::key(const fs::path &path, const std::string &contents, const std::string &state) const {
+    ArchiveWriter archive;
+    
+    archive.write(NUMERIC_BUILD);
+    archive.write(fs::absolute(path).lexically_normal().string());
+    archive.write(contents);
+    archive.write(state);
+    
+    return digest(archive.data());
+}
+
+std::optional<TranslationCache::TEntry> TranslationCache::lookup(const std::string &key) {
+    if (!enabled) return std::nullopt;
+    
+    std::optional<TEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) entry = it->second;
+    }
+    
+    bool fetched = false;
+    if (!entry) {
+        entry = fetch(key);
+        if (!entry) return std::nullopt;
+        fetched = true;
+        
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.emplace(key, *entry);
+    }
+    
+    std::error_code ec;
+    fs::path path = directory / (key + ".cache");
+    
+    // Any file read by the translation having changed since makes the entry stale.
+    for (const auto &dependency : entry->dependencies) {
+        if (fileDigest(dependency.first) == dependency.second) continue;
+        
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _entries.erase(key);
+        }
+        fs::remove(path, ec);
+        return std::nullopt;
+    }
+    
+    // Marked as used, so pruning removes those least recently used first.
+    if (fetched) fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    
+    return entry;
+}
+
+std::optional<TranslationCache::TEntry> TranslationCache::fetch(const std::string &key) const {
+    auto contents = read(directory / (key + ".cache"));
+    if (!contents) return std::nullopt;
+    
+    ArchiveReader archive(*contents);
+    TEntry entry;
+    std::string str;
+    size_t count = 0;
+    
+    if (!archive.read(str) || str != signature) return std::nullopt;
+    
+    archive.read(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string path, digest;
+        archive.read(path);
+        if (!archive.read(digest)) return std::nullopt;
+        entry.dependencies.emplace(path, digest);
+    }
+    
+    archive.read(entry.output);
+    archive.read(entry.state);
+    if (archive.failed()) return std::nullopt;
+    
+    return entry;
+}
+
+void TranslationCache::store(const std::string &key, const TEntry &entry) {
+    if (!enabled) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries[key] = entry;
+    }
+    
+    ArchiveWriter archive;
+    archive.write(signature);
+    archive.write(entry.dependencies.size());
+    for (const auto &dependency : entry.dependencies) {
+        archive.write(dependency.first.string());
+        archive.write(dependency.second);
+    }
+    archive.write(entry.output);
+    archive.write(entry.state);
+    
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) return;
+    
+    // Written aside and then renamed into place, so an entry is never seen part written.
+    fs::path path = directory / (key + ".cache");
+    auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    fs::path temporary = directory / (key + "." + std::to_string(getpid()) + "-" + std::to_string(thread) + ".tmp");
+    
+    std::ofstream outfile(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open()) return;
+    outfile.write(archive.data().data(), static_cast<std::streamsize>(archive.data().size()));
+    outfile.close();
+    
+    if (outfile.fail()) {
+        fs::remove(temporary, ec);
+        return;
+    }
+    fs::rename(temporary, path, ec);
+    if (ec) fs::remove(temporary, ec);
+    
+    // Pruned on the first entry stored, then on every so many, so a long running process is held in check too.
+    bool pruning;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pruning = _stored++ % 64 == 0;
+    }
+    if (pruning) prune();
+}
+
+void TranslationCache::prune(void) const {
+    typedef struct {
+        fs::path path;
+        fs::file_time_type time;
+        std::uintmax_t size;
+    } file_t;
+    
+    std::vector<file_t> files;
+    std::uintmax_t total = 0;
+    std::error_code ec;
+    auto now = fs::file_time_type::clock::now();
+    
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        auto extension = it->path().extension();
+        if (extension != ".cache" && extension != ".tmp") continue;
+        
+        std::error_code error;
+        auto time = it->last_write_time(error);
+        auto size = it->file_size(error);
+        if (error) continue;
+        
+        // Any entry too old, or left part written long enough ago that nothing can be writing it still, goes.
+        if (now - time > (extension == ".tmp" ? std::chrono::hours(1) : maxAge)) {
+            fs::remove(it->path(), error);
+            continue;
+        }
+        if (extension == ".tmp") continue;
+        
+        files.push_back({it->path(), time, size});
+        total += size;
+    }
+    
+    if (total <= maxSize) return;
+    
+    std::sort(files.begin(), files.end(), [](const file_t &a, const file_t &b) { return a.time < b.time; });
+    for (const auto &file : files) {
+        if (total <= maxSize) break;
+        if (fs::remove(file.path, ec)) total -= file.size;
+    }
+}
+
+bool TranslationCache::clear(void) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+    
+    std::error_code ec;
+    if (directory.empty() || !fs::exists(directory, ec)) return true;
+    
+    bool cleared = true;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        auto extension = it->path().extension();
+        if (extension != ".cache" && extension != ".tmp") continue;
+        
+        std::error_code error;
+        if (!fs::remove(it->path(), error) || error) cleared = false;
+    }
+    return cleared && !ec;
+}
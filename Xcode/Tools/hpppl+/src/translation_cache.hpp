@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <filesystem>
+#include <chrono>
+#include <cstdint>
+
+namespace hppplplus {
+    /*
+     A persistent, content-addressed cache of the translations of included files.
+     
+     An entry is keyed by the content of the file and the translation state it was
+     translated in, and holds the PPL it translated to along with the state it left
+     behind. Each entry also records the digest of every file its translation read, so
+     it is only reused while all of them are unchanged.
+     
+     Entries are also kept in memory, so a long running process, such as one in server
+     mode, does not read the same entry from disk again.
+     
+     On disk, entries are kept in $XDG_CACHE_HOME/hpppl+, or ~/.cache/hpppl+. An entry
+     found stale is removed, and as entries are stored those unused for `maxAge`, then
+     the least recently used beyond `maxSize` in all, are removed too, as every edit of
+     an included file keys it anew.
+     */
+    class TranslationCache {
+    public:
+        typedef struct TEntry {
+            std::string output;     // the translated PPL
+            std::string state;      // the archived translation state after translating
+            std::map<std::filesystem::path, std::string> dependencies;
+        } TEntry;
+        
+        bool enabled = true;
+        std::filesystem::path directory;
+        
+        std::uintmax_t maxSize = 256 * 1024 * 1024;     // bytes
+        std::chrono::hours maxAge = std::chrono::hours(24 * 30);
+        
+        TranslationCache();
+        
+        static std::string digest(std::string_view data);
+        static std::string fileDigest(const std::filesystem::path &path);
+        
+        // The key of the file at `path`, whose contents have the digest `contents`, translated in `state`.
+        std::string key(const std::filesystem::path &path, const std::string &contents, const std::string &state) const;
+        
+        std::optional<TEntry> lookup(const std::string &key);
+        void store(const std::string &key, const TEntry &entry);
+        
+        // Removes every entry, returning false should any be left.
+        bool clear(void);
+        
+    private:
+        // Entries already read or stored, kept for as long as the process runs and shared by all its translations.
+        std::unordered_map<std::string, TEntry> _entries;
+        std::mutex _mutex;
+        size_t _stored = 0;
+        
+        // The entry as stored on disk, whether stale or not.
+        std::optional<TEntry> fetch(const std::string &key) const;
+        
+        // Removes the entries on disk too old, then the least recently used beyond the size allowed.
+        void prune(void) const;
+    };
+}
@@ -0,0 +1,200 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "translation_context.hpp"
+#include "translation_cache.hpp"
+
+using hppplplus::TranslationContext;
+using hppplplus::ArchiveWriter;
+using hppplplus::ArchiveReader;
+
+namespace fs = std::filesystem;
+
+static thread_local TranslationContext *_current = nullptr;
+
+TranslationContext::TranslationContext() : aliases(*this), regexp(*this), directives(*this), scopeDepth(_scopeDepth), count(_count) {
+}
+
+TranslationContext *TranslationContext::current(void) {
+    return _current;
+}
+
+TranslationContext::Binding::Binding(TranslationContext &context) : _previous(_current) {
+    _current = &context;
+}
+
+TranslationContext::Binding::~Binding() {
+    _current = _previous;
+}
+
+void TranslationContext::incrementLineNumber(void) {
+    ++_currentline;
+}
+
+long TranslationContext::currentLineNumber(void) const {
+    return _currentline;
+}
+
+fs::path TranslationContext::currentSourceFilePath(void) const {
+    if (_paths.empty()) return "";
+    return _paths.back();
+}
+
+void TranslationContext::pushPath(const fs::path &path) {
+    _paths.push_back(path.lexically_normal());
+    _lines.push_back(_currentline);
+    _currentline = 1;
+}
+
+void TranslationContext::popPath(void) {
+    _currentline = _lines.back();
+    _paths.pop_back();
+    _lines.pop_back();
+}
+
+void TranslationContext::unwind(void) {
+    while (!_paths.empty()) popPath();
+    _recordings.clear();
+}
+
+void TranslationContext::increaseScopeDepth(void) {
+    if (_scopeDepth == 0) {
+        _store = _count;
+        _count = 0;
+    }
+    _scopeDepth++;
+}
+
+void TranslationContext::decreaseScopeDepth(void) {
+    if (_scopeDepth == 0) {
+        *diagnostics << "Error: Unexpected '" << "END; at line:" << _currentline << "'\n";
+    } else {
+        if (_scopeDepth == 1) {
+            _count = _store;
+        }
+        _scopeDepth--;
+    }
+    
+    // Leaving a scope pops the frames of all the aliases and regular expressions local to it.
+    aliases.removeAllOutOfScopeAliases();
+    regexp.removeAllOutOfScopeRegexps();
+}
+
+void TranslationContext::beginRecording(void) {
+    _recordings.emplace_back();
+}
+
+std::map<fs::path, std::string> TranslationContext::endRecording(void) {
+    auto dependencies = std::move(_recordings.back());
+    _recordings.pop_back();
+    return dependencies;
+}
+
+void TranslationContext::dependsOn(const fs::path &path) {
+    if (_recordings.empty()) return;
+    
+    auto absolute = fs::absolute(path).lexically_normal();
+    auto digest = includes.digest(absolute);
+    for (auto &recording : _recordings) recording.emplace(absolute, digest);
+}
+
+void TranslationContext::dependsOn(const std::map<fs::path, std::string> &dependencies) {
+    for (const auto &dependency : dependencies) {
+        for (auto &recording : _recordings) recording.insert(dependency);
+    }
+}
+
+void TranslationContext::save(ArchiveWriter &archive, const bool locations) const {
+    archive.write(_scopeDepth);
+    archive.write(_count);
+    archive.write(_store);
+    codeStack.save(archive);
+    includes.save(archive);
+    aliases.save(archive, locations);
+    regexp.save(archive, locations);
+    
+    archive.write(indentation);
+    archive.write(directives.operators);
+    archive.write(directives.logicalOperators);
+    archive.write(directives.systemIncludePath.size());
+    for (const auto &path : directives.systemIncludePath) {
+        archive.write(path.string());
+    }
+    archive.write(addons.size());
+    for (const auto &addon : addons) {
+        archive.write(addon.command);
+        archive.write(addon.extension);
+    }
+}
+
+bool TranslationContext::load(ArchiveReader &archive) {
+    ArchiveWriter backup;
+    save(backup, true);
+    
+    if (restore(archive)) return true;
+    
+    ArchiveReader reader(backup.data());
+    restore(reader);
+    return false;
+}
+
+bool TranslationContext::restore(ArchiveReader &archive) {
+    int scopeDepth = 0, count = 0, store = 0;
+    unsigned int indentation = 2;
+    bool operators = true, logicalOperators = true;
+    size_t size = 0;
+    std::deque<fs::path> systemIncludePath;
+    std::vector<TAddon> addons;
+    
+    archive.read(scopeDepth);
+    archive.read(count);
+    archive.read(store);
+    if (archive.failed() || !codeStack.load(archive) || !includes.load(archive) || !aliases.load(archive) || !regexp.load(archive)) return false;
+    
+    archive.read(indentation);
+    archive.read(operators);
+    archive.read(logicalOperators);
+    archive.read(size);
+    for (size_t i = 0; i < size; ++i) {
+        std::string path;
+        archive.read(path);
+        systemIncludePath.push_back(path);
+    }
+    archive.read(size);
+    for (size_t i = 0; i < size; ++i) {
+        TAddon addon;
+        archive.read(addon.command);
+        archive.read(addon.extension);
+        addons.push_back(addon);
+    }
+    if (archive.failed()) return false;
+    
+    _scopeDepth = scopeDepth;
+    _count = count;
+    _store = store;
+    this->indentation = indentation;
+    directives.operators = operators;
+    directives.logicalOperators = logicalOperators;
+    directives.systemIncludePath = systemIncludePath;
+    this->addons = addons;
+    return true;
+}
@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <filesystem>
+
+#include "aliases.hpp"
+#include "common.hpp"
+#include "regexp.hpp"
+#include "code_stack.hpp"
+#include "include_table.hpp"
+#include "directives.hpp"
+#include "archive.hpp"
+
+namespace hppplplus {
+    /*
+     All the state of one translation: what has been defined, where translation is up
+     to, and what it has read and reported. Nothing a translation changes lives outside
+     its context, so a process can translate any number of programs, one after another
+     or at once on separate threads.
+     */
+    class TranslationContext {
+        
+    public:
+        typedef struct TAddon {
+            std::string command;
+            std::string extension;
+            std::vector<std::string> arguments; // Unused
+        } TAddon;
+        
+        Aliases aliases;
+        Regexp regexp;
+        CodeStack codeStack;
+        IncludeTable includes;
+        Directives directives;
+        std::vector<TAddon> addons;
+        unsigned int indentation = 2;
+        
+        const int &scopeDepth;
+        const int &count;
+        
+        // Set once an error has been reported, along with the number of diagnostics reported, verbose messages aside.
+        bool failed = false;
+        size_t messages = 0;
+        
+        // Where messages are reported to, so that translations running at once each keep their own.
+        std::ostream *diagnostics = &std::cerr;
+        
+        TranslationContext();
+        TranslationContext(const TranslationContext &) = delete;
+        TranslationContext &operator=(const TranslationContext &) = delete;
+        
+        /*
+         The context current on this thread, the one diagnostics are reported against,
+         or nullptr when there is none.
+         */
+        static TranslationContext *current(void);
+        
+        // Makes a context the current one on this thread for as long as it exists.
+        class Binding {
+        public:
+            Binding(TranslationContext &context);
+            ~Binding();
+            
+        private:
+            TranslationContext *_previous;
+        };
+        
+        void incrementLineNumber(void);
+        long currentLineNumber(void) const;
+        std::filesystem::path mainSourceFilePath(void) const
+        {
+            return std::filesystem::path(_paths.front());
+        }
+        
+        std::filesystem::path currentSourceFilePath(void) const;
+        
+        std::filesystem::path getMainSourceDir(void) const
+        {
+            return std::filesystem::path(_paths.front()).parent_path();
+        }
+        
+        void pushPath(const std::filesystem::path &path);
+        void popPath(void);
+        
+        // Drops any paths and recordings left behind by a translation that failed part way.
+        void unwind(void);
+        
+        void increaseScopeDepth(void);
+        void decreaseScopeDepth(void);
+        
+        void advanceCount(void) {
+            _count++;
+        }
+        
+        void resetCount(void) {
+            _count = 0;
+        }
+        
+        /*
+         Every translation in progress records the files it reads, so that any files read
+         by a nested translation are dependencies of all the translations enclosing it.
+         */
+        void beginRecording(void);
+        std::map<std::filesystem::path, std::string> endRecording(void);
+        void dependsOn(const std::filesystem::path &path);
+        void dependsOn(const std::map<std::filesystem::path, std::string> &dependencies);
+        
+        /*
+         Saves all the state that affects how a file is translated, or that translating
+         a file can change: the scope depth, the counter, the code stack, the files not to
+         be included again, every alias and regular expression, the indentation, the
+         operator settings, the include paths and the add-ons. Without `locations` the
+         archive leaves out where each alias and regular expression was defined.
+         */
+        void save(ArchiveWriter &archive, const bool locations) const;
+        
+        // Loading is all or nothing, an archive that fails to load part way leaves the state as it was.
+        bool load(ArchiveReader &archive);
+        
+    private:
+        std::vector<std::filesystem::path> _paths;
+        std::vector<long> _lines;
+        std::vector<std::map<std::filesystem::path, std::string>> _recordings;
+        
+        long _currentline = 1;
+        int _scopeDepth = 0;
+        int _count = 0;
+        int _store = 0;
+        
+        bool restore(ArchiveReader &archive);
+    };
+}
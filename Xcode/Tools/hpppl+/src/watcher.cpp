@@ -0,0 +1,180 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "watcher.hpp"
+
+#include <thread>
+#include <chrono>
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <climits>
+#endif
+
+using hppplplus::Watcher;
+
+namespace fs = std::filesystem;
+
+static fs::file_time_type modified(const fs::path &path) {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    return ec ? fs::file_time_type::min() : time;
+}
+
+void Watcher::poll(std::set<fs::path> &changed) {
+    for (auto &time : _times) {
+        auto current = modified(time.first);
+        if (current == time.second) continue;
+        time.second = current;
+        changed.insert(time.first);
+    }
+}
+
+std::set<fs::path> Watcher::waitByPolling(void) {
+    std::set<fs::path> changed;
+    
+    while (changed.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        poll(changed);
+    }
+    
+    // An editor saving a file can take several steps, so wait for the changes to settle.
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(debounce));
+        std::set<fs::path> more;
+        poll(more);
+        if (more.empty()) break;
+        changed.insert(more.begin(), more.end());
+    }
+    
+    return changed;
+}
+
+#if defined(__linux__)
+
+Watcher::Watcher() {
+    _fd = inotify_init1(IN_CLOEXEC);
+}
+
+Watcher::~Watcher() {
+    if (_fd != -1) close(_fd);
+}
+
+void Watcher::watch(const std::set<fs::path> &paths) {
+    for (const auto &directory : _directories) inotify_rm_watch(_fd, directory.first);
+    _directories.clear();
+    _paths.clear();
+    _times.clear();
+    
+    std::set<fs::path> directories;
+    for (const auto &path : paths) {
+        auto absolute = fs::absolute(path).lexically_normal();
+        _paths.insert(absolute);
+        directories.insert(absolute.parent_path());
+    }
+    
+    // Without inotify, or a watch on every directory, changes could be missed, so every file is polled instead.
+    _polling = _fd == -1;
+    for (const auto &directory : directories) {
+        if (_polling) break;
+        int wd = inotify_add_watch(_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MODIFY);
+        if (wd == -1) {
+            _polling = true;
+            break;
+        }
+        _directories[wd] = directory;
+    }
+    
+    if (_polling) {
+        for (const auto &directory : _directories) inotify_rm_watch(_fd, directory.first);
+        _directories.clear();
+        for (const auto &path : _paths) _times[path] = modified(path);
+    }
+}
+
+void Watcher::read(std::set<fs::path> &changed) {
+    alignas(struct inotify_event) char buffer[sizeof(struct inotify_event) + NAME_MAX + 1];
+    
+    ssize_t length = ::read(_fd, buffer, sizeof(buffer));
+    for (ssize_t offset = 0; offset < length; ) {
+        auto event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+        
+        auto directory = _directories.find(event->wd);
+        if (directory == _directories.end() || event->len == 0) continue;
+        
+        auto path = directory->second / event->name;
+        if (_paths.contains(path)) changed.insert(path);
+    }
+}
+
+std::set<fs::path> Watcher::wait(void) {
+    if (_polling) return waitByPolling();
+    
+    std::set<fs::path> changed;
+    struct pollfd fds = { .fd = _fd, .events = POLLIN };
+    
+    while (changed.empty()) {
+        if (::poll(&fds, 1, -1) > 0) read(changed);
+    }
+    
+    // An editor saving a file can take several steps, so wait for the changes to settle.
+    while (::poll(&fds, 1, debounce) > 0) read(changed);
+    
+    return changed;
+}
+
+bool Watcher::polling(void) const {
+    return _polling;
+}
+
+#else
+
+Watcher::Watcher() {
+}
+
+Watcher::~Watcher() {
+}
+
+void Watcher::watch(const std::set<fs::path> &paths) {
+    _paths.clear();
+    _times.clear();
+    
+    for (const auto &path : paths) {
+        auto absolute = fs::absolute(path).lexically_normal();
+        _paths.insert(absolute);
+        _times[absolute] = modified(absolute);
+    }
+}
+
+std::set<fs::path> Watcher::wait(void) {
+    return waitByPolling();
+}
+
+// Polling is how changes are found here, not a fallback.
+bool Watcher::polling(void) const {
+    return false;
+}
+
+#endif
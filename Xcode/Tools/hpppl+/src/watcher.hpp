@@ -0,0 +1,73 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <filesystem>
+#include <set>
+#include <map>
+
+namespace hppplplus {
+    /*
+     Waits for files to change.
+     
+     On Linux the directories holding the files are watched with inotify, since editors
+     often save by replacing a file rather than writing to it. Elsewhere, or should
+     inotify be unable to watch them all, such as once the watches a user may have are
+     used up, the files are polled for changes to their modification times.
+     */
+    class Watcher {
+    public:
+        // Milliseconds to wait for changes to settle before reporting them.
+        int debounce = 100;
+        
+        Watcher();
+        ~Watcher();
+        
+        Watcher(const Watcher&) = delete;
+        Watcher &operator=(const Watcher&) = delete;
+        
+        // Replaces the files watched.
+        void watch(const std::set<std::filesystem::path> &paths);
+        
+        // Blocks until any of the files watched changes, returning those that did.
+        std::set<std::filesystem::path> wait(void);
+        
+        // Whether the files are polled, having failed to be watched on a platform that can watch them.
+        bool polling(void) const;
+        
+    private:
+        std::set<std::filesystem::path> _paths;
+        std::map<std::filesystem::path, std::filesystem::file_time_type> _times;
+        
+#if defined(__linux__)
+        int _fd = -1;
+        bool _polling = false;
+        std::map<int, std::filesystem::path> _directories;
+        
+        void read(std::set<std::filesystem::path> &changed);
+#endif
+        
+        void poll(std::set<std::filesystem::path> &changed);
+        std::set<std::filesystem::path> waitByPolling(void);
+    };
+}
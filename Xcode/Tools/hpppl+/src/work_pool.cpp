@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2023-2026 Insoft.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "work_pool.hpp"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+
+using hppplplus::WorkPool;
+
+typedef struct TQueue {
+    std::deque<size_t> jobs;
+    std::mutex mutex;
+} TQueue;
+
+// Takes the job at the front of a queue, as its own thread does, or at the back, as any other does.
+static std::optional<size_t> take(TQueue &queue, const bool front) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return std::nullopt;
+    
+    size_t index = front ? queue.jobs.front() : queue.jobs.back();
+    if (front) queue.jobs.pop_front(); else queue.jobs.pop_back();
+    return index;
+}
+
+void WorkPool::run(const size_t count, const std::function<void(size_t)> &job) {
+    size_t threads = std::min(_threads, count);
+    
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) job(i);
+        return;
+    }
+    
+    std::vector<TQueue> queues(threads);
+    for (size_t i = 0; i < count; ++i) queues[i % threads].jobs.push_back(i);
+    
+    // No jobs are added once running, so a thread that finds every queue empty is done.
+    auto work = [&](const size_t self) {
+        while (true) {
+            auto index = take(queues[self], true);
+            for (size_t i = 1; !index && i < threads; ++i) {
+                index = take(queues[(self + i) % threads], false);
+            }
+            if (!index) return;
+            job(*index);
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) workers.emplace_back(work, i);
+    work(0);
+    for (auto &worker : workers) worker.join();
+}
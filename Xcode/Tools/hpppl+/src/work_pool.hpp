@@ -1,8 +1,6 @@
 // The MIT License (MIT)
 //
-// Copyright (c) 2024-2025 Insoft.
-//
-// Created: 2025-05-27
+// Copyright (c) 2023-2026 Insoft.
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -22,29 +20,27 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#ifndef utf_hpp
-#define utf_hpp
+#pragma once
 
-#include <sstream>
-#include <fstream>
-#include <cstdlib>
-#include <filesystem>
+#include <cstddef>
+#include <functional>
 
-namespace utf {
-    enum BOM {
-        BOMle,
-        BOMbe,
-        BOMnone
+namespace hppplplus {
+    /*
+     Runs a number of jobs on a fixed number of threads.
+     
+     The jobs are dealt out in turn to a queue per thread. Each thread runs the jobs at
+     the front of its own queue, and once it has none left steals from the back of
+     another's, so threads dealt quick jobs help those dealt slow ones.
+     */
+    class WorkPool {
+    public:
+        explicit WorkPool(const size_t threads) : _threads(threads ? threads : 1) {}
+        
+        // Runs `job` for each index below `count` and returns once all have run.
+        void run(const size_t count, const std::function<void(size_t)> &job);
+        
+    private:
+        size_t _threads;
     };
-    
-    std::string utf8(const std::wstring& wstr);
-    std::wstring utf16(const std::string& str);
-    std::wstring read(std::ifstream& is, BOM bom = BOMle);
-    std::wstring load(const std::filesystem::path& path, BOM bom = BOMle);
-    size_t write(std::ofstream& os, const std::string& str);
-    size_t write(std::ofstream& os, const std::wstring& wstr, BOM bom = BOMle);
-    bool save(const std::filesystem::path& path, const std::string& str);
-    bool save(const std::filesystem::path& path, const std::wstring& wstr, BOM bom = BOMle);
-};
-
-#endif /* utf_hpp */
+}